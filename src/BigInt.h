@@ -7,16 +7,52 @@
 #include <iostream>
 #include <iterator>
 #include <climits>
-#include <list>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
+#if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+#include <compare>
+#include <span>
+#endif
+
+#if (defined(__x86_64__) || defined(_M_X64)) && !defined(BIGINT_NO_INTRINSICS) // define to only use portable kernels
+#define BIGINT_X86_64
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// lets a function use instructions the rest of the program is not compiled for
+#if defined(BIGINT_X86_64) && defined(__GNUC__)
+#define BIGINT_TARGET(features) __attribute__((target(features)))
+#else
+#define BIGINT_TARGET(features)
+#endif
+
 using _ull = unsigned long long;
 using _ui = unsigned int;
 using _ld = long double;
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef unsigned __int128 _u128;
+#endif
 
 constexpr _ui BASE_BIN_LENGTH = static_cast<_ui>(std::numeric_limits<_ull>::digits / 2); // number of binary digits in the base
 constexpr _ull BASE = (ULLONG_MAX >> BASE_BIN_LENGTH) + 1; // base
@@ -46,8 +82,23 @@ static const _ui DOUBLE_CONVERSION = (log_const(DBL_MAX) / log_const(static_cast
 template<typename ty, typename = std::enable_if_t<std::is_integral_v<ty> && std::is_unsigned_v<ty>>>
 struct _integral_unsigned {};
 
+// ty must be unsigned integral type other than bool
+template<typename ty>
+constexpr bool _is_native_unsigned = std::is_integral_v<ty> && std::is_unsigned_v<ty> && !std::is_same_v<ty, bool> &&
+                                     std::numeric_limits<ty>::digits <= std::numeric_limits<_ull>::digits;
+
+// tag for the constructor making a number of only 0 digits
+struct zero_digits_t {};
+constexpr zero_digits_t zero_digits{};
+
+// ty must be floating point type
+template<typename ty, typename = std::enable_if_t<std::is_floating_point_v<ty>>>
+struct _floating {};
+
+class BigUnsignedView;
+
 class BigUnsigned {
-    // call resize_to_fit to ensure leading zeros are gone is using sz_ty_ull constructor
+    // call resize_to_fit to ensure leading zeros are gone is using zero_digits constructor
     // since all operations assume there are NO leading zeros
 public:
 
@@ -58,16 +109,16 @@ public:
 
 private:
 
-    // requires end - start <= MAX_DIGITS_NUM
+    // requires end - start <= BASE_DIGITS_ALLOW
     template<typename Forward>
     _ull _unchecked_to_num(Forward start, Forward end) {
 
-        _ld res = 0;
+        _ull res = 0;
         for (; start != end; ++start) {
-            res += static_cast<_ld>(*start) * std::pow(static_cast<_ld>(10), static_cast<_ld>(end - start - 1));
+            res = (res * 10) + *start;
         }
 
-        return static_cast<_ull>(std::llroundl(res));
+        return res;
 
     }
 
@@ -79,34 +130,7 @@ private:
     }
 
     // convert from base 10 to desired base
-    void _create(cont_ui::iterator digit_local_iter, sz_ty_ui size_local) {
-
-        std::list<_ull> digits_local; // to not have to preallocate required size
-
-        while (size_local >= BASE_DIGITS) {
-            _ull starting_num = _unchecked_to_num(digit_local_iter, digit_local_iter + BASE_DIGITS - 1);
-            auto end_cont = digit_local_iter + size_local;
-            auto start_cont = digit_local_iter + BASE_DIGITS - 1;
-            for (auto j = start_cont; j != end_cont; ++j, ++digit_local_iter) {
-                starting_num = (starting_num * 10) + *j;
-                *digit_local_iter = starting_num / BASE;
-                starting_num -= (starting_num / BASE) * BASE;
-            }
-            size_local = end_cont - start_cont;
-            digit_local_iter -= size_local;
-            digits_local.emplace_front(starting_num);
-        }
-
-        _ull num = _unchecked_to_num(digit_local_iter, digit_local_iter + size_local);
-        if (num != 0) {
-            digits_local.emplace_front(num);
-        }
-
-        std::copy(digits_local.cbegin(), digits_local.cend(), std::back_inserter(digits));
-
-        resize_to_fit();
-
-    }
+    void _create(cont_ui::iterator digit_local_iter, sz_ty_ui size_local);
 
 public:
 
@@ -166,7 +190,35 @@ public:
 
     }
 
-    explicit BigUnsigned(sz_ty_ull size) : digits(size, 0) {} // initialize to 0's to allow remove of extra ones
+    explicit BigUnsigned(zero_digits_t, sz_ty_ull size) : digits(size, 0) {} // initialize to 0's to allow remove of extra ones
+
+    template<typename Integral, std::enable_if_t<_is_native_unsigned<Integral>, int> = 0>
+    explicit BigUnsigned(Integral value) : digits() {
+
+        _ull val = value;
+        if ((val >> BASE_BIN_LENGTH) != 0) {
+            digits.push_back(val >> BASE_BIN_LENGTH);
+        }
+        if (val != 0) {
+            digits.push_back(val & (BASE - 1));
+        }
+
+    }
+
+#if defined(__SIZEOF_INT128__)
+    explicit BigUnsigned(_u128 value) : digits() {
+
+        for (; value != 0; value >>= BASE_BIN_LENGTH) {
+            digits.insert(digits.cbegin(), static_cast<_ull>(value & (BASE - 1)));
+        }
+
+    }
+#endif
+
+    explicit BigUnsigned(const BigUnsignedView& view); // copy digits out of a view
+
+    template<typename Floating, typename = _floating<Floating>>
+    explicit BigUnsigned(Floating value); // integer part of value
 
     // remove the leading 0's
     // if all 0's results in empty digits
@@ -176,10 +228,7 @@ public:
             return i == 0;
         });
 
-        if (iter != digits.cbegin()) {
-            cont_ull temp(iter, digits.cend());
-            digits = std::move(temp);
-        }
+        digits.erase(digits.cbegin(), iter);
 
     }
 
@@ -187,470 +236,4942 @@ public:
 
 };
 
-std::ostream& operator<< (std::ostream& out, const BigUnsigned& num) {
+// read only, non-owning view of digits laid out the same as BigUnsigned::digits
+// most signficant digit first, every digit in [0, BASE), no leading zeros
+// memory being viewed (BigUnsigned, mapped file, ...) must outlive the view
+class BigUnsignedView {
+public:
 
-    std::copy(num.digits.cbegin(), num.digits.cend(), std::ostream_iterator<_ull>(out, ", "));
-    return out;
+    using value_type = _ull;
+    using size_type = BigUnsigned::sz_ty_ull;
+    using const_iterator = const _ull*;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
-}
+    BigUnsignedView() : first(nullptr), len(0) {}
 
-inline auto _longer(const BigUnsigned* const l, const BigUnsigned* const r) {
+    BigUnsignedView(const _ull* const start, size_type size) : first(start), len(size) {}
 
-    return std::max(l, r, [](auto l, auto r) {
-        return l->digits.size() < r->digits.size();
-    });
+    BigUnsignedView(const BigUnsigned& num) : first(num.digits.data()), len(num.digits.size()) {}
 
-}
+    const _ull* data() const { return first; }
+    size_type size() const { return len; }
+    bool empty() const { return len == 0; }
 
-inline auto _shorter(const BigUnsigned* const l, const BigUnsigned* const r) {
+    const_iterator begin() const { return first; }
+    const_iterator end() const { return first + len; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+    const_reverse_iterator crbegin() const { return rbegin(); }
+    const_reverse_iterator crend() const { return rend(); }
 
-    return std::min(l, r, [](auto l, auto r) {
-        return l->digits.size() <= r->digits.size();
+    _ull operator[] (size_type i) const { return first[i]; }
+
+private:
+
+    const _ull* first;
+    size_type len;
+
+};
+
+BigUnsigned::BigUnsigned(const BigUnsignedView& view) : digits(view.cbegin(), view.cend()) {}
+
+using limb = _ull; // one digit, value in [0, BASE)
+
+#if defined(__cpp_lib_span)
+template<typename T>
+using LimbSpan = std::span<T>;
+#else
+// stand in for std::span before c++20, only what the kernels need
+template<typename T>
+class LimbSpan {
+public:
+
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using size_type = std::size_t;
+    using iterator = T*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+
+    LimbSpan() : ptr(nullptr), len(0) {}
+
+    LimbSpan(T* const start, size_type size) : ptr(start), len(size) {}
+
+    // anything with contiguous data() and size(), BigUnsigned::cont_ull, BigUnsignedView, ...
+    template<typename Container, typename = std::enable_if_t<
+        std::is_convertible_v<decltype(std::declval<Container&>().data()), T*>>>
+    LimbSpan(Container&& cont) : ptr(cont.data()), len(static_cast<size_type>(cont.size())) {}
+
+    T* data() const { return ptr; }
+    size_type size() const { return len; }
+    bool empty() const { return len == 0; }
+
+    iterator begin() const { return ptr; }
+    iterator end() const { return ptr + len; }
+    reverse_iterator rbegin() const { return reverse_iterator(end()); }
+    reverse_iterator rend() const { return reverse_iterator(begin()); }
+
+    T& operator[] (size_type i) const { return ptr[i]; }
+    T& front() const { return *ptr; }
+    T& back() const { return ptr[len - 1]; }
+
+    LimbSpan first(size_type count) const { return LimbSpan(ptr, count); }
+    LimbSpan last(size_type count) const { return LimbSpan(ptr + (len - count), count); }
+    LimbSpan subspan(size_type offset, size_type count = static_cast<size_type>(-1)) const {
+
+        return LimbSpan(ptr + offset, count == static_cast<size_type>(-1) ? len - offset : count);
+
+    }
+
+private:
+
+    T* ptr;
+    size_type len;
+
+};
+#endif
+
+// Kernels
+//
+// work on digits laid out the same as BigUnsigned::digits, most significant first
+// so they run on any memory: BigUnsigned, BigUnsignedView, mapped files, arenas, ...
+// shorter operands are aligned with the least significant end, leading zeros are allowed
+// nothing is allocated unless noted
+
+constexpr limb LIMB_MASK = BASE - 1;
+
+// num without its leading zeros
+inline LimbSpan<const limb> _strip_zeros(LimbSpan<const limb> num) {
+
+    auto iter = std::find_if_not(num.begin(), num.end(), [](auto i) {
+        return i == 0;
     });
+    return num.subspan(static_cast<std::size_t>(iter - num.begin()));
 
 }
 
-inline auto _longer_digits(const BigUnsigned* const l, const BigUnsigned* const r) {
+// decides the compare by the digits the longer of l and r has past the shorter, which must be 0
+// for the two to be equal, returns 1 or -1 if they do otherwise cuts them off and returns 0
+inline int _compare_top(LimbSpan<const limb>& l, LimbSpan<const limb>& r) {
 
-    return std::max(l, r, [](auto l, auto r) {
-        return l->digits.size() < r->digits.size();
-    })->digits;
+    for (; l.size() > r.size(); l = l.last(l.size() - 1)) {
+        if (l.front() != 0) {
+            return 1;
+        }
+    }
+    for (; r.size() > l.size(); r = r.last(r.size() - 1)) {
+        if (r.front() != 0) {
+            return -1;
+        }
+    }
+
+    return 0;
 
 }
 
-inline auto _shorter_digits(const BigUnsigned* const l, const BigUnsigned* const r) {
+// compare_limbs in portable code
+int _compare_limbs_generic(LimbSpan<const limb> l, LimbSpan<const limb> r) {
 
-    return std::min(l, r, [](auto l, auto r) {
-        return l->digits.size() <= r->digits.size();
-    })->digits;
+    if (int top = _compare_top(l, r)) {
+        return top;
+    }
+
+    for (std::size_t i = 0; i != l.size(); ++i) {
+        if (l[i] != r[i]) {
+            return l[i] < r[i] ? -1 : 1;
+        }
+    }
+
+    return 0;
 
 }
 
-bool operator< (const BigUnsigned& l, const BigUnsigned& r) {
+// add_limbs in portable code
+limb _add_limbs_generic(LimbSpan<limb> res, LimbSpan<const limb> l, LimbSpan<const limb> r) {
 
-    _ui l_len = l.digits.size();
-    _ui r_len = r.digits.size();
-    if (l_len < r_len) {
-         return true;
-    } else if (l_len > r_len) {
-        return false;
-    } 
+    if (l.size() < r.size()) {
+        std::swap(l, r);
+    }
 
-    auto l_iter = l.digits.cbegin();
-    auto r_iter = r.digits.cbegin();
-    while (l_iter != l.digits.cend() && *l_iter == *r_iter) {
-        ++l_iter;
-        ++r_iter;
+    auto res_iter = res.data() + res.size();
+    auto l_iter = l.data() + l.size();
+    auto r_iter = r.data() + r.size();
+
+    limb carry = 0;
+    while (r_iter != r.data()) {
+        limb sum = *--l_iter + *--r_iter + carry;
+        carry = sum >> BASE_BIN_LENGTH;
+        *--res_iter = sum & LIMB_MASK;
+    }
+    while (carry != 0 && l_iter != l.data()) {
+        limb sum = *--l_iter + carry;
+        carry = sum >> BASE_BIN_LENGTH;
+        *--res_iter = sum & LIMB_MASK;
+    }
+    if (res_iter != l_iter) { // nothing left to carry, rest of l is copied
+        std::copy_backward(l.data(), l_iter, res_iter);
     }
 
-    return *l_iter < *r_iter;
+    return carry;
 
 }
 
-bool operator> (const BigUnsigned& l, const BigUnsigned& r) {
+// sub_limbs in portable code
+limb _sub_limbs_generic(LimbSpan<limb> res, LimbSpan<const limb> l, LimbSpan<const limb> r) {
 
-    return r < l;
+    auto res_iter = res.data() + res.size();
+    auto l_iter = l.data() + l.size();
+    auto r_iter = r.data() + r.size();
+
+    limb borrow = 0;
+    while (r_iter != r.data()) {
+        limb diff = *--l_iter - *--r_iter - borrow; // wraps around when negative
+        borrow = diff >> (std::numeric_limits<limb>::digits - 1);
+        *--res_iter = diff & LIMB_MASK;
+    }
+    while (borrow != 0 && l_iter != l.data()) {
+        limb diff = *--l_iter - borrow;
+        borrow = diff >> (std::numeric_limits<limb>::digits - 1);
+        *--res_iter = diff & LIMB_MASK;
+    }
+    if (res_iter != l_iter) { // nothing left to borrow, rest of l is copied
+        std::copy_backward(l.data(), l_iter, res_iter);
+    }
+
+    return borrow;
 
 }
 
-bool operator<= (const BigUnsigned& l, const BigUnsigned& r) {
+// mul_limb in portable code
+limb _mul_limb_generic(LimbSpan<limb> res, LimbSpan<const limb> l, const limb digit, limb carry) {
 
-    _ui l_len = l.digits.size();
-    _ui r_len = r.digits.size();
-    if (l_len > r_len) {
-        return false;
-    } else if (l_len < r_len) {
-        return true;
-    }
+    auto res_iter = res.data() + res.size();
+    auto l_iter = l.data() + l.size();
 
-    auto l_iter = l.digits.cbegin();
-    auto r_iter = r.digits.cbegin();
-    while (*l_iter == *r_iter && l_iter != l.digits.cend()) {
-        ++l_iter;
-        ++r_iter;
+    while (l_iter != l.data()) {
+        limb prod = *--l_iter * digit + carry; // (BASE - 1)^2 + (BASE - 1) < BASE^2
+        carry = prod >> BASE_BIN_LENGTH;
+        *--res_iter = prod & LIMB_MASK;
     }
 
-    return (*l_iter <= *r_iter) || (l_iter == l.digits.cend());
+    return carry;
 
 }
 
-bool operator>= (const BigUnsigned& l, const BigUnsigned& r) {
+// addmul_limb in portable code
+limb _addmul_limb_generic(LimbSpan<limb> res, LimbSpan<const limb> l, const limb digit) {
 
-    _ui l_len = l.digits.size();
-    _ui r_len = r.digits.size();
-    if (l_len > r_len) {
-        return true;
-    } else if (l_len < r_len) {
-        return false;
-    }
+    auto res_iter = res.data() + res.size();
+    auto l_iter = l.data() + l.size();
 
-    auto l_iter = l.digits.cbegin();
-    auto r_iter = r.digits.cbegin();
-    while (*l_iter == *r_iter && l_iter != l.digits.cend()) {
-        ++l_iter;
-        ++r_iter;
+    limb carry = 0;
+    while (l_iter != l.data()) {
+        --res_iter;
+        limb prod = *--l_iter * digit + *res_iter + carry; // (BASE - 1)^2 + 2(BASE - 1) < BASE^2
+        carry = prod >> BASE_BIN_LENGTH;
+        *res_iter = prod & LIMB_MASK;
     }
 
-    return (*l_iter >= *r_iter) || (l_iter == l.digits.cend());
+    return carry;
 
 }
 
-// theta(max(l.size, r.size))
-BigUnsigned operator+ (const BigUnsigned& l, const BigUnsigned& r) {
+enum class _BitOp { bit_and, bit_or, bit_xor };
 
-    auto longer = ::_longer(&l, &r);
-    auto shorter = ::_shorter(&l, &r);
+template<_BitOp Op>
+inline limb _bit_op(limb l, limb r) {
+
+    if constexpr (Op == _BitOp::bit_and) {
+        return l & r;
+    } else if constexpr (Op == _BitOp::bit_or) {
+        return l | r;
+    } else {
+        return l ^ r;
+    }
 
-    BigUnsigned result(longer->digits.size() + 1);
-    auto new_digits = result.digits.rbegin();
+}
+
+// and_limbs, or_limbs and xor_limbs in portable code
+template<_BitOp Op>
+void _bitwise_limbs_generic(LimbSpan<limb> res, LimbSpan<const limb> l, LimbSpan<const limb> r) {
 
-    auto l_iter = longer->digits.crbegin();
-    _ull carry = 0;
-    for (auto s_iter = shorter->digits.crbegin(); s_iter != shorter->digits.crend(); ++l_iter, ++s_iter, ++new_digits) {
-        _ull result = *l_iter + *s_iter + carry;
-        carry = result >> BASE_BIN_LENGTH;
-        *new_digits = result - (BASE * carry);
+    for (std::size_t i = 0; i != res.size(); ++i) {
+        res[i] = _bit_op<Op>(l[i], r[i]);
     }
 
-    for (; l_iter != longer->digits.crend(); ++l_iter, ++new_digits) {
-        _ull result = *l_iter + carry;
-        carry = result >> BASE_BIN_LENGTH;
-        *new_digits = result - (BASE * carry);
+}
+
+// not_limbs in portable code
+void _not_limbs_generic(LimbSpan<limb> res, LimbSpan<const limb> num) {
+
+    for (std::size_t i = 0; i != res.size(); ++i) {
+        res[i] = num[i] ^ LIMB_MASK;
     }
-    
-    if (carry != 0) {
-        // result.digits.emplace(result.digits.cbegin(), carry);
-        result.digits.emplace(std::find_if_not(result.digits.cbegin(), result.digits.cend(), [](auto val) {
-            return val == 0;
-        }), carry);
+
+}
+
+// shl_limbs in portable code
+limb _shl_limbs_generic(LimbSpan<limb> res, LimbSpan<const limb> num, const _ui bits) {
+
+    const auto len = num.size();
+    if (len == 0) {
+        return 0;
     }
 
-    result.resize_to_fit();
+    const limb out = num[0] >> (BASE_BIN_LENGTH - bits); // shifting a digit by BASE_BIN_LENGTH is 0, not undefined
+    for (std::size_t i = 0; i + 1 < len; ++i) {
+        res[i] = ((num[i] << bits) | (num[i + 1] >> (BASE_BIN_LENGTH - bits))) & LIMB_MASK;
+    }
+    res[len - 1] = (num[len - 1] << bits) & LIMB_MASK;
 
-    return result;
+    return out;
 
 }
 
-// theta(max(l.size, r.size))
-// note: doesnt care about order, the shorter number will be subtracted
-// from the longer one, and if same length then smaller from larger
-BigUnsigned operator- (const BigUnsigned& l, const BigUnsigned& r) {
+// shr_limbs in portable code
+limb _shr_limbs_generic(LimbSpan<limb> res, LimbSpan<const limb> num, const _ui bits) {
 
-    auto longer = ::_longer(&l, &r);
-    auto shorter = ::_shorter(&l, &r);
+    const auto len = num.size();
+    if (len == 0) {
+        return 0;
+    }
 
-    BigUnsigned result(longer->digits.size());
-    auto new_digits = result.digits.rbegin();
+    const limb out = num[len - 1] & ((limb(1) << bits) - 1);
+    for (std::size_t i = len - 1; i != 0; --i) {
+        res[i] = ((num[i] >> bits) | (num[i - 1] << (BASE_BIN_LENGTH - bits))) & LIMB_MASK;
+    }
+    res[0] = num[0] >> bits;
 
-    if (l.digits.size() == r.digits.size()) { // same size
-        auto l_iter = l.digits.crbegin();
-        auto r_iter = r.digits.crbegin();
+    return out;
 
-        if (l > r) {
-            _ull carry = 0;
-            for (; l_iter != l.digits.crend(); ++l_iter, ++r_iter, ++new_digits) { // issue is crend includes the 0's need to get rid of the 0's somehow
-                _ull result = (*l_iter - carry) - *r_iter;
-                carry = (result >> BASE_BIN_LENGTH) & 1;
-                *new_digits = (result << BASE_BIN_LENGTH) >> BASE_BIN_LENGTH;
-            }
-        } else if (r > l) {
-            _ull carry = 0;
-            for (; l_iter != l.digits.crend(); ++l_iter, ++r_iter, ++new_digits) {
-                _ull result = (*r_iter - carry) - *l_iter;
-                carry = (result >> BASE_BIN_LENGTH) & 1;
-                *new_digits = (result << BASE_BIN_LENGTH) >> BASE_BIN_LENGTH;
-            }
-        } else {
-            return BigUnsigned("0");
-        }
-    } else {
-        auto l_iter = longer->digits.crbegin();
-        _ull carry = 0;
-        for (auto s_iter = shorter->digits.crbegin(); s_iter != shorter->digits.crend(); ++l_iter, ++s_iter, ++new_digits) {
-            _ull result = (*l_iter - carry) - *s_iter;
-            carry = (result >> BASE_BIN_LENGTH) & 1; // if carry is needed, then & 1 will always produce 1
-            *new_digits = (result << BASE_BIN_LENGTH) >> BASE_BIN_LENGTH;
-        }
+}
 
-        for (; l_iter != longer->digits.crend(); ++l_iter, ++new_digits) {
-            _ull result = *l_iter - carry;
-            carry = (result >> BASE_BIN_LENGTH) & 1;
-            *new_digits = (result << BASE_BIN_LENGTH) >> BASE_BIN_LENGTH;
+// mul_limbs in portable code
+void _mul_limbs_generic(LimbSpan<limb> res, LimbSpan<const limb> l, LimbSpan<const limb> r) {
+
+    std::fill(res.begin(), res.end(), 0);
+
+    auto row = res.data() + (res.size() - l.size()); // digits res += l * digit lands on
+    for (auto r_iter = r.data() + r.size(); r_iter != r.data(); --row) {
+        limb digit = *--r_iter;
+        if (digit != 0) {
+            *(row - 1) = _addmul_limb_generic(LimbSpan<limb>(row, l.size()), l, digit); // not yet written by any earlier row
         }
     }
 
-    result.resize_to_fit();
+}
 
-    return result;
+// sqr_limbs in portable code
+// every product of two different digits is made once and doubled, about half the work of mul_limbs
+void _sqr_limbs_generic(LimbSpan<limb> res, LimbSpan<const limb> num) {
 
-}
+    const auto len = num.size();
+    std::fill(res.begin(), res.end(), 0);
 
-// theta(2 * l.size * r.size) really slow
-// i dont care enough to use a fast multiplication algorithm since i dont care enough
-// if needed will implement
-BigUnsigned operator* (const BigUnsigned& l, const BigUnsigned& r) {
+    // digit i (from least significant) times every more significant digit lands on res from i + i + 1
+    for (std::size_t i = 0; i + 1 < len; ++i) {
+        limb digit = num[len - 1 - i];
+        if (digit != 0) {
+            res[len - 1 - i] = _addmul_limb_generic(LimbSpan<limb>(res.data() + len - i, len - 1 - i), num.first(len - 1 - i), digit);
+        }
+    }
+
+    // double and add the squares of every digit
+    auto res_iter = res.data() + res.size();
+    limb carry = 0;
+    for (auto iter = num.data() + len; iter != num.data(); ) {
+        limb digit = *--iter;
+        limb square = digit * digit;
+        --res_iter;
+        limb sum = (*res_iter << 1) + (square & LIMB_MASK) + carry; // 2(BASE - 1) + (BASE - 1) + 2 < 2^64
+        carry = sum >> BASE_BIN_LENGTH;
+        *res_iter = sum & LIMB_MASK;
+        --res_iter;
+        sum = (*res_iter << 1) + (square >> BASE_BIN_LENGTH) + carry;
+        carry = sum >> BASE_BIN_LENGTH;
+        *res_iter = sum & LIMB_MASK;
+    }
+
+}
 
-    BigUnsigned res("0");
+#if defined(__SIZEOF_INT128__) || (defined(BIGINT_X86_64) && defined(_MSC_VER))
+#define BIGINT_WORDS // 64 bit * 64 bit = 128 bit multiplication is available
 
-    for (auto r_iter = r.digits.crbegin(); r_iter != r.digits.crend(); ++r_iter) {
-        _ui shift = std::distance(r.digits.crbegin(), r_iter);
+// pairs of digits as 64 bit words, least significant word first
+inline void _pack_words(LimbSpan<const limb> num, std::uint64_t* words, std::size_t word_count) {
 
-        BigUnsigned curr(l.digits.size() + 1 + shift);
-        auto curr_iter = curr.digits.rbegin();
-        for (_ui i = 0; i != shift; ++i, ++curr_iter) {
-            *curr_iter = 0;
+    auto iter = num.data() + num.size();
+    for (std::size_t i = 0; i != word_count; ++i) {
+        std::uint64_t word = iter != num.data() ? *--iter : 0;
+        if (iter != num.data()) {
+            word |= *--iter << BASE_BIN_LENGTH;
         }
-        _ull carry = 0;
-        for (auto l_iter = l.digits.crbegin(); l_iter != l.digits.crend(); ++l_iter, ++curr_iter) {
-            _ull result = *l_iter * *r_iter + carry;
-            carry = result >> BASE_BIN_LENGTH;
-            *curr_iter = result - (BASE * carry);
+        words[i] = word;
+    }
+
+}
+
+// res_64 += l_64 * digit over l_words words, returns the word carried out
+// gcc and clang keep a 128 bit sum in registers and emit mul/mulx and adc themselves
+// spelling the carry chains out with _addcarry_u64 makes them spill the carry flag every word
+// msvc has no 128 bit integer but keeps the flags for the intrinsics, there one chain joins the
+// halves of the products and a second adds the row into res_64, which is what adcx and adox are for
+template<bool Mulx>
+inline std::uint64_t _addmul_words(std::uint64_t* res_64, const std::uint64_t* l_64, std::size_t l_words, std::uint64_t digit) {
+
+#if defined(__SIZEOF_INT128__)
+    std::uint64_t carry = 0;
+    for (std::size_t i = 0; i != l_words; ++i) {
+        _u128 sum = static_cast<_u128>(l_64[i]) * digit + res_64[i] + carry; // (2^64 - 1)^2 + 2(2^64 - 1) < 2^128
+        res_64[i] = static_cast<std::uint64_t>(sum);
+        carry = static_cast<std::uint64_t>(sum >> 64);
+    }
+    return carry;
+#else
+    unsigned char carry_prod = 0;
+    unsigned char carry_row = 0;
+    unsigned long long prev_high = 0;
+    for (std::size_t i = 0; i != l_words; ++i) {
+        unsigned long long high;
+        unsigned long long low;
+        unsigned long long word;
+        unsigned long long sum;
+        if constexpr (Mulx) {
+            low = _mulx_u64(l_64[i], digit, &high);
+            carry_prod = _addcarryx_u64(carry_prod, low, prev_high, &word);
+            carry_row = _addcarryx_u64(carry_row, res_64[i], word, &sum);
+        } else {
+            low = _umul128(l_64[i], digit, &high);
+            carry_prod = _addcarry_u64(carry_prod, low, prev_high, &word);
+            carry_row = _addcarry_u64(carry_row, res_64[i], word, &sum);
         }
-        *curr_iter = carry;
+        res_64[i] = sum;
+        prev_high = high;
+    }
+    return prev_high + carry_prod + carry_row; // row fits in l_words + 1 words
+#endif
+
+}
 
-        res = res + curr;
+// 64 bit words back to digits, most significant first
+inline void _unpack_words(const std::uint64_t* words, LimbSpan<limb> res) {
+
+    auto res_iter = res.data() + res.size();
+    for (std::size_t i = 0; res_iter != res.data(); ++i) {
+        *--res_iter = words[i] & LIMB_MASK;
+        if (res_iter != res.data()) {
+            *--res_iter = words[i] >> BASE_BIN_LENGTH;
+        }
     }
 
-    return res;
+}
+
+// sum = l + r + carry, returns the carry out
+inline unsigned char _add_words(unsigned char carry, std::uint64_t l, std::uint64_t r, std::uint64_t& sum) {
+
+#if defined(__SIZEOF_INT128__)
+    _u128 full = static_cast<_u128>(l) + r + carry;
+    sum = static_cast<std::uint64_t>(full);
+    return static_cast<unsigned char>(full >> 64);
+#else
+    unsigned long long out;
+    carry = _addcarry_u64(carry, l, r, &out);
+    sum = out;
+    return carry;
+#endif
 
 }
 
-// Meant for positive only
-BigUnsigned divide_digit(typename BigUnsigned::cont_ull::const_iterator start, typename BigUnsigned::cont_ull::const_iterator end, const _ull digit) {
+// returns the low word of l * r, high is set to the high word
+inline std::uint64_t _mul_words(std::uint64_t l, std::uint64_t r, std::uint64_t& high) {
 
-    BigUnsigned res(std::distance(start, end));
-    auto iter_res = res.digits.begin();
+#if defined(__SIZEOF_INT128__)
+    _u128 full = static_cast<_u128>(l) * r;
+    high = static_cast<std::uint64_t>(full >> 64);
+    return static_cast<std::uint64_t>(full);
+#else
+    unsigned long long out;
+    std::uint64_t low = _umul128(l, r, &out);
+    high = out;
+    return low;
+#endif
 
-    _ull carry = 0;
+}
+
+// res_64 = l_64 * r_64, words least significant first, res_64 must be l_words + r_words words of 0
+template<bool Mulx>
+inline void _mul_words_rows(std::uint64_t* res_64, const std::uint64_t* l_64, std::size_t l_words, const std::uint64_t* r_64, std::size_t r_words) {
 
-    for (; start != end; ++start, ++iter_res) {
-        *iter_res = (*start + (carry * BASE)) / digit;
-        carry = *start - (digit * *iter_res); 
+    for (std::size_t j = 0; j != r_words; ++j) {
+        if (r_64[j] != 0) {
+            res_64[j + l_words] = _addmul_words<Mulx>(res_64 + j, l_64, l_words, r_64[j]); // not yet written
+        }
     }
 
-    res.resize_to_fit();
+}
 
-    return res;
+// res_64 = num_64 * num_64, res_64 must be 2 * words words of 0
+template<bool Mulx>
+inline void _sqr_words_rows(std::uint64_t* res_64, const std::uint64_t* num_64, std::size_t words) {
+
+    for (std::size_t i = 0; i + 1 < words; ++i) {
+        if (num_64[i] != 0) {
+            res_64[i + words] = _addmul_words<Mulx>(res_64 + i + i + 1, num_64 + i + 1, words - i - 1, num_64[i]);
+        }
+    }
+
+    // a word can not hold its doubled value, the top bit moves into the next word
+    std::uint64_t top = 0;
+    unsigned char carry = 0;
+    for (std::size_t i = 0; i != words; ++i) {
+        std::uint64_t high;
+        std::uint64_t low = _mul_words(num_64[i], num_64[i], high);
+        std::uint64_t word = res_64[i + i];
+        carry = _add_words(carry, (word << 1) | top, low, res_64[i + i]);
+        top = word >> 63;
+        word = res_64[i + i + 1];
+        carry = _add_words(carry, (word << 1) | top, high, res_64[i + i + 1]);
+        top = word >> 63;
+    }
 
 }
 
-BigUnsigned divide(const BigUnsigned* const remainder, const BigUnsigned* const denom, const _ull digit) {
+constexpr std::size_t WORDS_MIN_LIMBS = 8; // below this packing into words costs more than it saves
 
-    return divide_digit(remainder->digits.cbegin(), remainder->digits.cbegin() + (remainder->digits.size() - denom->digits.size() + 1), digit);
+// same as _mul_limbs_generic, digits are multiplied two at a time as 64 bit words
+// a quarter of the multiplications, allocates 64 bit copies of l, r and res
+template<bool Mulx>
+inline void _mul_limbs_words_impl(LimbSpan<limb> res, LimbSpan<const limb> l, LimbSpan<const limb> r) {
 
-}
+    if (l.size() < WORDS_MIN_LIMBS || r.size() < WORDS_MIN_LIMBS) {
+        _mul_limbs_generic(res, l, r);
+        return;
+    }
+
+    const std::size_t l_words = (l.size() + 1) / 2;
+    const std::size_t r_words = (r.size() + 1) / 2;
+    std::vector<std::uint64_t> scratch(2 * (l_words + r_words), 0);
+    auto l_64 = scratch.data();
+    auto r_64 = l_64 + l_words;
+    auto res_64 = r_64 + r_words;
+    _pack_words(l, l_64, l_words);
+    _pack_words(r, r_64, r_words);
 
-// Meant for negative only
-BigUnsigned divide_digit_neg(typename BigUnsigned::cont_ull::const_iterator start, typename BigUnsigned::cont_ull::const_iterator end, const _ull digit) {
+    _mul_words_rows<Mulx>(res_64, l_64, l_words, r_64, r_words);
 
-    BigUnsigned res(std::distance(start, end));
-    auto iter_res = res.digits.begin();
+    _unpack_words(res_64, res);
 
-    _ull carry = 0;
+}
+
+// same as _sqr_limbs_generic over 64 bit words
+template<bool Mulx>
+inline void _sqr_limbs_words_impl(LimbSpan<limb> res, LimbSpan<const limb> num) {
 
-    for (; start != end - 1; ++start, ++iter_res) {
-        *iter_res = (*start + (carry * BASE)) / digit;
-        carry = *start - (digit * *iter_res); 
+    if (num.size() < WORDS_MIN_LIMBS) {
+        _sqr_limbs_generic(res, num);
+        return;
     }
-    
-    *iter_res = (*start + digit + (carry * BASE)) / digit; // add digit since when negative integers rounded down is the same as rounding up when positive
 
-    res.resize_to_fit();
+    const std::size_t words = (num.size() + 1) / 2;
+    std::vector<std::uint64_t> scratch(3 * words, 0);
+    auto num_64 = scratch.data();
+    auto res_64 = num_64 + words;
+    _pack_words(num, num_64, words);
 
-    // std::cout << "res: " << res << std::endl;
+    _sqr_words_rows<Mulx>(res_64, num_64, words);
 
-    return res;
+    _unpack_words(res_64, res);
 
 }
 
-BigUnsigned divide_neg(const BigUnsigned* const remainder, const BigUnsigned* const denom, const _ull digit) {
+void _mul_limbs_words(LimbSpan<limb> res, LimbSpan<const limb> l, LimbSpan<const limb> r) {
 
-    // std::cout << "hmm2 " << (remainder->digits.size() - denom->digits.size() + 1) << std::endl;
-    return divide_digit_neg(remainder->digits.cbegin(), remainder->digits.cbegin() + (remainder->digits.size() - denom->digits.size() + 1), digit);
+    _mul_limbs_words_impl<false>(res, l, r);
 
 }
 
-// issue when there is a 1 digit in numerator
-
-// theta(c * n.size * operator*) slow
-// c is some constant which is < 1
-// i dont care enough to use a fast division algorithm since they all require decimals
-// if needed will implement
-// Note: To use n >= d
-BigUnsigned operator/ (const BigUnsigned& n, const BigUnsigned& d) {
+void _sqr_limbs_words(LimbSpan<limb> res, LimbSpan<const limb> num) {
 
-    _ui m = d.digits.size() - 1;
-    _ull a = *d.digits.cbegin();
-    BigUnsigned q = divide(&n, &d, a);
-    q.resize_to_fit();
-    BigUnsigned r = d;
+    _sqr_limbs_words_impl<false>(res, num);
 
-    if (n > q * d) { // division is complete
-        return q;
-    }
+}
+#endif
 
-    while (r >= d && r.digits.size() > 0) {
-        // std::cout << "u" << std::endl;
-        r = n - (q * d);     
-        if (r.digits.size() >= d.digits.size()) {
-            // std::cout << r << std::endl;
-            // std::cout << (r.digits.size()) << " " << (d.digits.size()) << std::endl;
+#if defined(BIGINT_X86_64)
+// _mul_limbs_words built for bmi2 and adx, cpu must support both
+// gcc and clang emit mulx with adc for it, only msvc uses the adcx and adox carry chains
+BIGINT_TARGET("bmi2,adx")
+void _mul_limbs_mulx(LimbSpan<limb> res, LimbSpan<const limb> l, LimbSpan<const limb> r) {
 
-            auto qn = q - divide_neg(&r, &d, a); 
-            auto sum = q + qn;
-            q = divide_digit(sum.digits.cbegin(), sum.digits.cend(), 2);
-        }
-    }
+    _mul_limbs_words_impl<true>(res, l, r);
 
-    // std::cout << "done" << std::endl;
+}
 
+BIGINT_TARGET("bmi2,adx")
+void _sqr_limbs_mulx(LimbSpan<limb> res, LimbSpan<const limb> num) {
 
-    return q;
+    _sqr_limbs_words_impl<true>(res, num);
 
 }
+#endif
 
-BigUnsigned pow(const BigUnsigned& base, const BigUnsigned& pow) {
+#if defined(BIGINT_X86_64)
+// Vector kernels
+// every digit takes a 64 bit lane, so avx2 works on 4 digits at once and avx512 on 8
+// only called through the kernel table once the cpu is known to support them
 
-    BigUnsigned res("1");
-    auto base_copy = base;
-    auto pow_copy = pow;
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized" // gcc 12 avx512 headers trip it in _mm512_undefined_epi32
+#endif
 
-    while (pow_copy.digits.size() != 0) {
-        if (*pow_copy.digits.crbegin() % 2 == 1) {
-            res = base_copy * res;
-        }
-        pow_copy = pow_copy / BigUnsigned("2");
-        base_copy = base_copy * base_copy;
-    }
+inline _ui _lowest_set_bit(_ui mask) {
 
-    return res;
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<_ui>(index);
+#else
+    return static_cast<_ui>(__builtin_ctz(mask));
+#endif
 
 }
 
-template<typename T>
-T _add_10(T* l, T* r) {
+BIGINT_TARGET("avx2")
+inline __m256i _load_4(const limb* digits) {
 
-    auto longer = std::max(l, r, [](auto l, auto r) {
-        return l->size() < r->size();
-    });
-    
-    auto shorter = std::min(l, r, [](auto l, auto r) {
-        return l->size() <= r->size();
-    });
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(digits));
+
+}
 
-    T ret(longer->size());
-    auto ret_iter = ret.rbegin();
-    auto l_iter = longer->crbegin();
-    typename T::value_type carry = 0;
-    for (auto s_iter = shorter->crbegin(); s_iter != shorter->crend(); ++l_iter, ++s_iter, ++ret_iter) {
-        *ret_iter = (carry + *l_iter + *s_iter) % 10;
-        carry = (carry + *l_iter + *s_iter) >= 10 ? 1 : 0; 
+BIGINT_TARGET("avx2")
+inline void _store_4(limb* digits, __m256i val) {
 
-    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(digits), val);
 
-    for (; l_iter != longer->crend(); ++l_iter, ++ret_iter) {
+}
 
-        *ret_iter = (carry + *l_iter) % 10;
-        carry = (carry + *l_iter) >= 10 ? 1 : 0; 
+BIGINT_TARGET("avx512f")
+inline __m512i _load_8(const limb* digits) {
 
-    }
+    return _mm512_loadu_si512(digits);
 
-    if (carry != 0) {
-        ret.insert(ret.cbegin(), carry);
-    }
+}
+
+BIGINT_TARGET("avx512f")
+inline void _store_8(limb* digits, __m512i val) {
 
-    return ret;
+    _mm512_storeu_si512(digits, val);
 
 }
 
-template<typename T>
-T _mult_10(T* l, T* r) {
+// the first count lanes of a mask
+inline __mmask8 _first_lanes(std::size_t count) {
 
-    T ret(1, 0);
-    for (auto iter_r = r->rbegin(); iter_r != r->rend(); ++iter_r) {
-        _ui shift = std::distance(r->rbegin(), iter_r);
+    return static_cast<__mmask8>((1u << count) - 1);
 
-        T curr(l->size() + 1 + shift);
-        auto curr_iter = curr.rbegin();
-        for (_ui i = 0; i != shift; ++i, ++curr_iter) {
-            *curr_iter = 0;
-        }
+}
 
-        typename T::value_type carry = 0;
-        for (auto iter_l = l->crbegin(); iter_l != l->crend(); ++iter_l, ++curr_iter) {
-            *curr_iter = (*iter_l * *iter_r + carry) % 10;
-            carry = ((*iter_l * *iter_r + carry) - *curr_iter) / 10;
-        }
-        *curr_iter = carry;
+BIGINT_TARGET("avx2")
+int _compare_limbs_avx2(LimbSpan<const limb> l, LimbSpan<const limb> r) {
+
+    if (int top = _compare_top(l, r)) {
+        return top;
+    }
 
-        ret = _add_10(&ret, &curr);
+    const std::size_t len = l.size();
+    std::size_t i = 0;
+    for (; i + 4 <= len; i += 4) {
+        __m256i same = _mm256_cmpeq_epi64(_load_4(l.data() + i), _load_4(r.data() + i));
+        _ui differ = ~static_cast<_ui>(_mm256_movemask_pd(_mm256_castsi256_pd(same))) & 0xF;
+        if (differ != 0) {
+            i += _lowest_set_bit(differ);
+            return l[i] < r[i] ? -1 : 1;
+        }
+    }
+    for (; i != len; ++i) {
+        if (l[i] != r[i]) {
+            return l[i] < r[i] ? -1 : 1;
+        }
     }
 
-    return ret;
+    return 0;
 
 }
 
-// return base 10 container representation of a bigunsigned
-// with most signficant digits in the container being lower index
-BigUnsigned::cont_ull BigUnsigned_10(const BigUnsigned& num) {
+BIGINT_TARGET("avx512f")
+int _compare_limbs_avx512(LimbSpan<const limb> l, LimbSpan<const limb> r) {
 
-    BigUnsigned::cont_ull base_vec(BASE_DIGITS);
-    BigUnsigned::cont_ull res(1, 0);
+    if (int top = _compare_top(l, r)) {
+        return top;
+    }
 
-    auto base = BASE;
-    for (auto iter = base_vec.rbegin(); iter != base_vec.rend(); ++iter) {
-        *iter = base % 10;
-        base /= 10;
+    const std::size_t len = l.size();
+    for (std::size_t i = 0; i < len; i += 8) {
+        __mmask8 lanes = len - i >= 8 ? _first_lanes(8) : _first_lanes(len - i);
+        _ui differ = _mm512_mask_cmpneq_epu64_mask(lanes, _mm512_maskz_loadu_epi64(lanes, l.data() + i),
+                                                    _mm512_maskz_loadu_epi64(lanes, r.data() + i));
+        if (differ != 0) {
+            i += _lowest_set_bit(differ);
+            return l[i] < r[i] ? -1 : 1;
+        }
     }
-    BigUnsigned::cont_ull power_curr_vec{1};
 
-    using value_ty = BigUnsigned::cont_ull::value_type;
+    return 0;
 
-    for (auto iter = num.digits.crbegin(); iter != num.digits.crend(); ++iter) {
+}
 
-        BigUnsigned::cont_ull digit_cont;
-        BigUnsigned::cont_ull::value_type digit = *iter;
-        while (digit > 0) {
-            digit_cont.insert(digit_cont.begin(), digit % 10);
-            digit /= 10;
+template<_BitOp Op>
+BIGINT_TARGET("avx2")
+void _bitwise_limbs_avx2(LimbSpan<limb> res, LimbSpan<const limb> l, LimbSpan<const limb> r) {
+
+    const std::size_t len = res.size();
+    std::size_t i = 0;
+    for (; i + 4 <= len; i += 4) {
+        __m256i l_4 = _load_4(l.data() + i);
+        __m256i r_4 = _load_4(r.data() + i);
+        if constexpr (Op == _BitOp::bit_and) {
+            _store_4(res.data() + i, _mm256_and_si256(l_4, r_4));
+        } else if constexpr (Op == _BitOp::bit_or) {
+            _store_4(res.data() + i, _mm256_or_si256(l_4, r_4));
+        } else {
+            _store_4(res.data() + i, _mm256_xor_si256(l_4, r_4));
         }
+    }
+    for (; i != len; ++i) {
+        res[i] = _bit_op<Op>(l[i], r[i]);
+    }
 
-        auto temp = _mult_10(&digit_cont, &power_curr_vec);
-        res = _add_10(&res, &temp);
-
-        power_curr_vec = _mult_10(&power_curr_vec, &base_vec);
+}
 
+template<_BitOp Op>
+BIGINT_TARGET("avx512f")
+void _bitwise_limbs_avx512(LimbSpan<limb> res, LimbSpan<const limb> l, LimbSpan<const limb> r) {
+
+    const std::size_t len = res.size();
+    for (std::size_t i = 0; i < len; i += 8) {
+        __mmask8 lanes = len - i >= 8 ? _first_lanes(8) : _first_lanes(len - i);
+        __m512i l_8 = _mm512_maskz_loadu_epi64(lanes, l.data() + i);
+        __m512i r_8 = _mm512_maskz_loadu_epi64(lanes, r.data() + i);
+        if constexpr (Op == _BitOp::bit_and) {
+            _mm512_mask_storeu_epi64(res.data() + i, lanes, _mm512_and_si512(l_8, r_8));
+        } else if constexpr (Op == _BitOp::bit_or) {
+            _mm512_mask_storeu_epi64(res.data() + i, lanes, _mm512_or_si512(l_8, r_8));
+        } else {
+            _mm512_mask_storeu_epi64(res.data() + i, lanes, _mm512_xor_si512(l_8, r_8));
+        }
     }
 
-    auto iter = std::find_if_not(res.cbegin(), res.cend(), [](auto i) {
-            return i == 0;
-    });
+}
 
-    if (iter != res.cbegin()) {
-        return BigUnsigned::cont_ull(iter, res.cend());
-    }
+BIGINT_TARGET("avx2")
+void _not_limbs_avx2(LimbSpan<limb> res, LimbSpan<const limb> num) {
 
-    return res;
+    const __m256i mask = _mm256_set1_epi64x(static_cast<long long>(LIMB_MASK));
+    const std::size_t len = res.size();
+    std::size_t i = 0;
+    for (; i + 4 <= len; i += 4) {
+        _store_4(res.data() + i, _mm256_xor_si256(_load_4(num.data() + i), mask));
+    }
+    for (; i != len; ++i) {
+        res[i] = num[i] ^ LIMB_MASK;
+    }
 
 }
 
-// return base 10 double representation of a bigunsigned if possible
-// if not, return -1
-double BigUnsigned_10_dbl(const BigUnsigned& num) {
-    // if -1 is returned then use BigUnsigned_10
-    // Note: double is not accurate, use other function for guarnteed accuracy
+BIGINT_TARGET("avx512f")
+void _not_limbs_avx512(LimbSpan<limb> res, LimbSpan<const limb> num) {
 
-    if (num.digits.size() > DOUBLE_CONVERSION) {
-        return -1;
+    const __m512i mask = _mm512_set1_epi64(static_cast<long long>(LIMB_MASK));
+    const std::size_t len = res.size();
+    for (std::size_t i = 0; i < len; i += 8) {
+        __mmask8 lanes = len - i >= 8 ? _first_lanes(8) : _first_lanes(len - i);
+        _mm512_mask_storeu_epi64(res.data() + i, lanes, _mm512_xor_si512(_mm512_maskz_loadu_epi64(lanes, num.data() + i), mask));
     }
 
-    double res = 0.0;
-    double i = 0;
-    for (auto iter = num.digits.rbegin(); iter != num.digits.rend(); ++iter) {
-        res += pow(static_cast<double>(BASE), i) * static_cast<double>(*iter);
-        ++i;
+}
+
+// digit i of the result is made from digits i and i + 1 of num, both loaded before digit i is
+// stored, going from the most significant end never reads a digit already written
+BIGINT_TARGET("avx2")
+limb _shl_limbs_avx2(LimbSpan<limb> res, LimbSpan<const limb> num, const _ui bits) {
+
+    const std::size_t len = num.size();
+    if (len == 0) {
+        return 0;
+    }
+
+    const limb out = num[0] >> (BASE_BIN_LENGTH - bits);
+    const __m256i mask = _mm256_set1_epi64x(static_cast<long long>(LIMB_MASK));
+    const __m128i left = _mm_cvtsi32_si128(static_cast<int>(bits));
+    const __m128i right = _mm_cvtsi32_si128(static_cast<int>(BASE_BIN_LENGTH - bits));
+    std::size_t i = 0;
+    for (; i + 4 < len; i += 4) {
+        __m256i high = _mm256_sll_epi64(_load_4(num.data() + i), left);
+        __m256i low = _mm256_srl_epi64(_load_4(num.data() + i + 1), right);
+        _store_4(res.data() + i, _mm256_and_si256(_mm256_or_si256(high, low), mask));
+    }
+    for (; i + 1 < len; ++i) {
+        res[i] = ((num[i] << bits) | (num[i + 1] >> (BASE_BIN_LENGTH - bits))) & LIMB_MASK;
+    }
+    res[len - 1] = (num[len - 1] << bits) & LIMB_MASK;
+
+    return out;
+
+}
+
+BIGINT_TARGET("avx512f")
+limb _shl_limbs_avx512(LimbSpan<limb> res, LimbSpan<const limb> num, const _ui bits) {
+
+    const std::size_t len = num.size();
+    if (len == 0) {
+        return 0;
+    }
+
+    const limb out = num[0] >> (BASE_BIN_LENGTH - bits);
+    const __m512i mask = _mm512_set1_epi64(static_cast<long long>(LIMB_MASK));
+    const __m128i left = _mm_cvtsi32_si128(static_cast<int>(bits));
+    const __m128i right = _mm_cvtsi32_si128(static_cast<int>(BASE_BIN_LENGTH - bits));
+    std::size_t i = 0;
+    for (; i + 8 < len; i += 8) {
+        __m512i high = _mm512_sll_epi64(_load_8(num.data() + i), left);
+        __m512i low = _mm512_srl_epi64(_load_8(num.data() + i + 1), right);
+        _store_8(res.data() + i, _mm512_and_si512(_mm512_or_si512(high, low), mask));
+    }
+    for (; i + 1 < len; ++i) {
+        res[i] = ((num[i] << bits) | (num[i + 1] >> (BASE_BIN_LENGTH - bits))) & LIMB_MASK;
+    }
+    res[len - 1] = (num[len - 1] << bits) & LIMB_MASK;
+
+    return out;
+
+}
+
+// mirror of _shl_limbs_avx2, digit i is made from digits i - 1 and i going from the least significant end
+BIGINT_TARGET("avx2")
+limb _shr_limbs_avx2(LimbSpan<limb> res, LimbSpan<const limb> num, const _ui bits) {
+
+    const std::size_t len = num.size();
+    if (len == 0) {
+        return 0;
+    }
+
+    const limb out = num[len - 1] & ((limb(1) << bits) - 1);
+    const __m256i mask = _mm256_set1_epi64x(static_cast<long long>(LIMB_MASK));
+    const __m128i right = _mm_cvtsi32_si128(static_cast<int>(bits));
+    const __m128i left = _mm_cvtsi32_si128(static_cast<int>(BASE_BIN_LENGTH - bits));
+    std::size_t i = len;
+    for (; i > 4; i -= 4) {
+        __m256i low = _mm256_srl_epi64(_load_4(num.data() + i - 4), right);
+        __m256i high = _mm256_sll_epi64(_load_4(num.data() + i - 5), left);
+        _store_4(res.data() + i - 4, _mm256_and_si256(_mm256_or_si256(high, low), mask));
+    }
+    for (; i > 1; --i) {
+        res[i - 1] = ((num[i - 1] >> bits) | (num[i - 2] << (BASE_BIN_LENGTH - bits))) & LIMB_MASK;
+    }
+    res[0] = num[0] >> bits;
+
+    return out;
+
+}
+
+BIGINT_TARGET("avx512f")
+limb _shr_limbs_avx512(LimbSpan<limb> res, LimbSpan<const limb> num, const _ui bits) {
+
+    const std::size_t len = num.size();
+    if (len == 0) {
+        return 0;
+    }
+
+    const limb out = num[len - 1] & ((limb(1) << bits) - 1);
+    const __m512i mask = _mm512_set1_epi64(static_cast<long long>(LIMB_MASK));
+    const __m128i right = _mm_cvtsi32_si128(static_cast<int>(bits));
+    const __m128i left = _mm_cvtsi32_si128(static_cast<int>(BASE_BIN_LENGTH - bits));
+    std::size_t i = len;
+    for (; i > 8; i -= 8) {
+        __m512i low = _mm512_srl_epi64(_load_8(num.data() + i - 8), right);
+        __m512i high = _mm512_sll_epi64(_load_8(num.data() + i - 9), left);
+        _store_8(res.data() + i - 8, _mm512_and_si512(_mm512_or_si512(high, low), mask));
+    }
+    for (; i > 1; --i) {
+        res[i - 1] = ((num[i - 1] >> bits) | (num[i - 2] << (BASE_BIN_LENGTH - bits))) & LIMB_MASK;
+    }
+    res[0] = num[0] >> bits;
+
+    return out;
+
+}
+
+// 8 digits, most significant first, each below 2^64 - 2^32, brought into [0, BASE) by moving
+// carries toward lane 0, out is set to what is carried out of lane 0
+// the carry into a lane depends on every less significant lane, but only through lanes of
+// exactly BASE - 1, which is done on the lane masks instead of digit by digit
+BIGINT_TARGET("avx512f")
+inline __m512i _carry_block_avx512(__m512i block, limb& out) {
+
+    const __m512i mask = _mm512_set1_epi64(static_cast<long long>(LIMB_MASK));
+    __m512i high = _mm512_srli_epi64(block, BASE_BIN_LENGTH);
+    out = static_cast<limb>(_mm_cvtsi128_si64(_mm512_castsi512_si128(high)));
+    block = _mm512_add_epi64(_mm512_and_si512(block, mask), _mm512_alignr_epi64(_mm512_setzero_si512(), high, 1)); // lane i gets the high half of lane i + 1
+
+    // every lane is now at most 2 * (BASE - 1) so carries at most 1
+    _ui generate = _mm512_cmpgt_epu64_mask(block, mask);
+    _ui propagate = _mm512_cmpeq_epu64_mask(block, mask);
+    _ui carry = generate >> 1;
+    for (_ui next; (next = carry | ((carry & propagate) >> 1)) != carry; carry = next) {}
+    out += (generate | (carry & propagate)) & 1;
+
+    block = _mm512_mask_add_epi64(block, static_cast<__mmask8>(carry), block, _mm512_set1_epi64(1));
+    return _mm512_and_si512(block, mask);
+
+}
+
+// stores block at digits and adds carry to its least significant digit, returns the carry out of the block
+// the digit the carry goes into is taken from the register, so the carry chain does not wait on the store
+BIGINT_TARGET("avx512f")
+inline limb _store_carry_block(limb* digits, __m512i block, limb carry, limb out) {
+
+    _store_8(digits, block);
+    limb sum = static_cast<limb>(_mm_extract_epi64(_mm512_extracti32x4_epi32(block, 3), 1)) + carry;
+    if (sum < BASE) {
+        digits[7] = sum;
+        return out;
+    }
+
+    digits[7] = sum & LIMB_MASK;
+    carry = sum >> BASE_BIN_LENGTH;
+    for (auto iter = digits + 7; carry != 0 && iter != digits; ) {
+        sum = *--iter + carry;
+        *iter = sum & LIMB_MASK;
+        carry = sum >> BASE_BIN_LENGTH;
+    }
+    return carry + out;
+
+}
+
+// blocks of 8 products are normalized without waiting on the carry of the block before, which is
+// added in afterwards and rarely moves past the least significant digit of the block
+BIGINT_TARGET("avx512f")
+limb _mul_limb_avx512(LimbSpan<limb> res, LimbSpan<const limb> l, const limb digit, limb carry) {
+
+    const __m512i factor = _mm512_set1_epi64(static_cast<long long>(digit));
+    auto i = l.size();
+    for (; i >= 8; i -= 8) {
+        limb out;
+        __m512i block = _carry_block_avx512(_mm512_mul_epu32(_load_8(l.data() + i - 8), factor), out);
+        carry = _store_carry_block(res.data() + i - 8, block, carry, out);
+    }
+    while (i != 0) {
+        --i;
+        limb prod = l[i] * digit + carry;
+        carry = prod >> BASE_BIN_LENGTH;
+        res[i] = prod & LIMB_MASK;
+    }
+
+    return carry;
+
+}
+
+BIGINT_TARGET("avx512f")
+limb _addmul_limb_avx512(LimbSpan<limb> res, LimbSpan<const limb> l, const limb digit) {
+
+    const __m512i factor = _mm512_set1_epi64(static_cast<long long>(digit));
+    limb carry = 0;
+    auto i = l.size();
+    for (; i >= 8; i -= 8) {
+        limb out;
+        __m512i prod = _mm512_mul_epu32(_load_8(l.data() + i - 8), factor);
+        prod = _mm512_add_epi64(prod, _load_8(res.data() + i - 8)); // (BASE - 1)^2 + (BASE - 1) < 2^64 - 2^32
+        __m512i block = _carry_block_avx512(prod, out);
+        carry = _store_carry_block(res.data() + i - 8, block, carry, out);
+    }
+    while (i != 0) {
+        --i;
+        limb prod = l[i] * digit + res[i] + carry;
+        carry = prod >> BASE_BIN_LENGTH;
+        res[i] = prod & LIMB_MASK;
+    }
+
+    return carry;
+
+}
+
+constexpr std::size_t IFMA_MIN_LIMBS = 48; // below this _mul_limbs_mulx is faster
+constexpr std::size_t IFMA_MAX_ROWS = 2048; // a column of more products could overflow its 64 bit sum
+constexpr std::size_t IFMA_VECTORS = 4; // columns done at once are IFMA_VECTORS * 8
+
+// schoolbook multiplication by columns, res[a + b + 1] gets l[a] * r[b]
+// vpmadd52luq and vpmadd52huq add the low 52 bits and the high bits of 8 products to 8 column sums,
+// the column sums stay apart in those two parts and no carry moves until every product is added
+// cpu must support avx512ifma, bmi2 and adx
+BIGINT_TARGET("avx512f,avx512ifma,bmi2,adx")
+void _mul_limbs_ifma(LimbSpan<limb> res, LimbSpan<const limb> l, LimbSpan<const limb> r) {
+
+    if (l.size() < r.size()) {
+        std::swap(l, r);
+    }
+    if (r.size() < IFMA_MIN_LIMBS) {
+        _mul_limbs_mulx(res, l, r);
+        return;
+    }
+
+    if (r.size() > IFMA_MAX_ROWS) { // r a piece at a time from its least significant end
+        std::fill(res.begin(), res.end(), 0);
+        std::vector<limb> part(l.size() + IFMA_MAX_ROWS);
+        for (std::size_t end = r.size(); end != 0; ) {
+            std::size_t start = end > IFMA_MAX_ROWS ? end - IFMA_MAX_ROWS : 0;
+            LimbSpan<limb> part_span(part.data(), l.size() + end - start);
+            _mul_limbs_ifma(part_span, l, r.subspan(start, end - start));
+            _add_limbs_generic(res.first(l.size() + end), res.first(l.size() + end), part_span); // lands r.size() - end digits up
+            end = start;
+        }
+        return;
+    }
+
+    constexpr std::size_t cols = IFMA_VECTORS * 8;
+    const std::size_t l_len = l.size();
+    const std::size_t r_len = r.size();
+    const std::size_t len = l_len + r_len;
+
+    std::vector<limb> scratch((l_len + 2 * cols) + 2 * (len + cols), 0);
+    limb* l_pad = scratch.data() + cols; // cols zero digits on each side so loads may run past l
+    std::copy(l.begin(), l.end(), l_pad);
+    limb* sum_low = l_pad + l_len + cols;
+    limb* sum_high = sum_low + len + cols;
+
+    for (std::size_t k = 1; k < len; k += cols) {
+        __m512i low[IFMA_VECTORS];
+        __m512i high[IFMA_VECTORS];
+        for (std::size_t v = 0; v != IFMA_VECTORS; ++v) {
+            low[v] = _mm512_setzero_si512();
+            high[v] = _mm512_setzero_si512();
+        }
+
+        // rows with a product landing in columns [k, k + cols)
+        const std::size_t b_first = k > l_len ? k - l_len : 0;
+        const std::size_t b_last = std::min(r_len - 1, k + cols - 2);
+        for (std::size_t b = b_first; b <= b_last; ++b) {
+            const limb* digits = l_pad - cols + (k + cols - 1 - b); // l[k - 1 - b]
+            const __m512i factor = _mm512_set1_epi64(static_cast<long long>(r[b]));
+            for (std::size_t v = 0; v != IFMA_VECTORS; ++v) {
+                __m512i l_8 = _load_8(digits + 8 * v);
+                low[v] = _mm512_madd52lo_epu64(low[v], l_8, factor);
+                high[v] = _mm512_madd52hi_epu64(high[v], l_8, factor);
+            }
+        }
+
+        for (std::size_t v = 0; v != IFMA_VECTORS; ++v) {
+            _store_8(sum_low + k + 8 * v, low[v]);
+            _store_8(sum_high + k + 8 * v, high[v]);
+        }
+    }
+
+    // column k is sum_low[k] + sum_high[k] * 2^52, sum_low[k] < IFMA_MAX_ROWS * 2^52 <= 2^63
+    limb carry = 0;
+    for (std::size_t k = len - 1; k != 0; --k) {
+        limb sum = sum_low[k] + carry;
+        res[k] = sum & LIMB_MASK;
+        carry = (sum >> BASE_BIN_LENGTH) + (sum_high[k] << (52 - BASE_BIN_LENGTH));
+    }
+    res[0] = carry;
+
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+// q = n / digit, returns n % digit
+// requires q.size() == n.size() and 0 < digit < BASE
+// q may be the same memory as n
+limb divmod_limb(LimbSpan<limb> q, LimbSpan<const limb> n, const limb digit) {
+
+    limb rem = 0;
+    for (decltype(n.size()) i = 0; i != n.size(); ++i) {
+        limb curr = (rem << BASE_BIN_LENGTH) | n[i];
+        q[i] = curr / digit;
+        rem = curr - (q[i] * digit);
+    }
+
+    return rem;
+
+}
+
+// divmod_limbs in portable code
+// Knuth's algorithm D with the divisor normalized so its leading digit is at least BASE / 2
+// allocates n.size() + d.size() digits of scratch
+void _divmod_limbs_generic(LimbSpan<limb> q, LimbSpan<limb> r, LimbSpan<const limb> n, LimbSpan<const limb> d) {
+
+    const auto d_len = d.size();
+    const auto n_len = n.size();
+
+    if (d_len == 1) {
+        r[0] = divmod_limb(q, n, d[0]);
+        return;
+    }
+
+    // least significant first from here on
+    auto d_at = [&](std::size_t i) { return d[d_len - 1 - i]; };
+    auto n_at = [&](std::size_t i) { return n[n_len - 1 - i]; };
+
+    _ui shift = 0;
+    for (limb top = d[0]; top < (BASE >> 1); top <<= 1) {
+        ++shift;
+    }
+    const _ui back_shift = BASE_BIN_LENGTH - shift; // shifting a digit by BASE_BIN_LENGTH is 0, not undefined
+
+    std::vector<limb> dn(d_len);
+    std::vector<limb> un(n_len + 1);
+    for (std::size_t i = d_len - 1; i != 0; --i) {
+        dn[i] = ((d_at(i) << shift) | (d_at(i - 1) >> back_shift)) & LIMB_MASK;
+    }
+    dn[0] = (d_at(0) << shift) & LIMB_MASK;
+    un[n_len] = n_at(n_len - 1) >> back_shift;
+    for (std::size_t i = n_len - 1; i != 0; --i) {
+        un[i] = ((n_at(i) << shift) | (n_at(i - 1) >> back_shift)) & LIMB_MASK;
+    }
+    un[0] = (n_at(0) << shift) & LIMB_MASK;
+
+    const limb d_top = dn[d_len - 1];
+    const limb d_next = dn[d_len - 2];
+
+    for (std::size_t j = n_len - d_len + 1; j-- != 0; ) {
+        // estimate is at most 2 too large
+        limb top = (un[j + d_len] << BASE_BIN_LENGTH) | un[j + d_len - 1];
+        limb q_hat = top / d_top;
+        limb r_hat = top - (q_hat * d_top);
+        while (q_hat >= BASE || q_hat * d_next > ((r_hat << BASE_BIN_LENGTH) | un[j + d_len - 2])) {
+            --q_hat;
+            r_hat += d_top;
+            if (r_hat >= BASE) {
+                break;
+            }
+        }
+
+        // un[j, j + d_len] -= q_hat * dn
+        long long borrow = 0;
+        long long diff;
+        for (std::size_t i = 0; i != d_len; ++i) {
+            limb prod = q_hat * dn[i];
+            diff = static_cast<long long>(un[i + j]) - borrow - static_cast<long long>(prod & LIMB_MASK);
+            un[i + j] = static_cast<limb>(diff) & LIMB_MASK;
+            borrow = static_cast<long long>(prod >> BASE_BIN_LENGTH) - (diff >> BASE_BIN_LENGTH);
+        }
+        diff = static_cast<long long>(un[j + d_len]) - borrow;
+        un[j + d_len] = static_cast<limb>(diff) & LIMB_MASK;
+
+        if (diff < 0) { // estimate was one too large, add back
+            --q_hat;
+            limb carry = 0;
+            for (std::size_t i = 0; i != d_len; ++i) {
+                limb sum = un[i + j] + dn[i] + carry;
+                carry = sum >> BASE_BIN_LENGTH;
+                un[i + j] = sum & LIMB_MASK;
+            }
+            un[j + d_len] = (un[j + d_len] + carry) & LIMB_MASK;
+        }
+
+        q[q.size() - 1 - j] = q_hat;
+    }
+
+    for (std::size_t i = 0; i != d_len; ++i) {
+        r[d_len - 1 - i] = ((un[i] >> shift) | (un[i + 1] << back_shift)) & LIMB_MASK;
+    }
+
+}
+
+// Runtime kernel selection
+
+// instruction sets kernels are chosen by, every level includes the ones before it
+// generic - portable code on 32 bit digits
+// words   - 64 bit * 64 bit = 128 bit multiplication
+// bmi2    - mulx (bmi2 and adx), with adcx and adox carry chains only on msvc
+// avx2    - 256 bit vectors
+// avx512  - 512 bit vectors (avx512f, avx512bw and avx512vl)
+enum class CpuLevel { generic, words, bmi2, avx2, avx512 };
+
+struct CpuFeatures {
+    bool bmi2 = false;
+    bool adx = false;
+    bool avx2 = false;
+    bool avx512f = false;
+    bool avx512bw = false;
+    bool avx512vl = false;
+    bool avx512ifma = false;
+};
+
+#if defined(BIGINT_X86_64)
+inline void _cpuid(_ui leaf, _ui sub_leaf, _ui (&regs)[4]) {
+
+#if defined(_MSC_VER)
+    int out[4];
+    __cpuidex(out, static_cast<int>(leaf), static_cast<int>(sub_leaf));
+    for (int i = 0; i != 4; ++i) {
+        regs[i] = static_cast<_ui>(out[i]);
+    }
+#else
+    __cpuid_count(leaf, sub_leaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+
+}
+
+// register state the os saves on a context switch, a vector unit is only usable if it is saved
+inline std::uint64_t _xcr0() {
+
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    _ui low;
+    _ui high;
+    __asm__ __volatile__("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+    return (static_cast<std::uint64_t>(high) << 32) | low;
+#endif
+
+}
+
+inline CpuFeatures _detect_cpu_features() {
+
+    CpuFeatures res;
+    _ui regs[4]; // eax, ebx, ecx, edx
+
+    _cpuid(0, 0, regs);
+    if (regs[0] < 7) {
+        return res;
+    }
+
+    _cpuid(1, 0, regs);
+    const bool os_xsave = (regs[2] >> 27) & 1;
+    const std::uint64_t xcr0 = os_xsave ? _xcr0() : 0;
+    const bool os_avx = (xcr0 & 0x6) == 0x6; // xmm and ymm
+    const bool os_avx512 = os_avx && (xcr0 & 0xE0) == 0xE0; // opmask and both halves of zmm
+
+    _cpuid(7, 0, regs);
+    res.bmi2 = (regs[1] >> 8) & 1;
+    res.adx = (regs[1] >> 19) & 1;
+    res.avx2 = os_avx && ((regs[1] >> 5) & 1);
+    res.avx512f = os_avx512 && ((regs[1] >> 16) & 1);
+    res.avx512bw = os_avx512 && ((regs[1] >> 30) & 1);
+    res.avx512vl = os_avx512 && ((regs[1] >> 31) & 1);
+    res.avx512ifma = os_avx512 && ((regs[1] >> 21) & 1);
+
+    return res;
+
+}
+#endif
+
+// features of the cpu running the program, detected on first use
+const CpuFeatures& cpu_features() {
+
+#if defined(BIGINT_X86_64)
+    static const CpuFeatures features = _detect_cpu_features();
+#else
+    static const CpuFeatures features;
+#endif
+    return features;
+
+}
+
+// highest level the cpu running the program supports
+CpuLevel cpu_level_supported() {
+
+    const auto& features = cpu_features();
+#if defined(BIGINT_X86_64)
+    if (!features.bmi2 || !features.adx) {
+        return CpuLevel::words;
+    }
+    if (!features.avx2) {
+        return CpuLevel::bmi2;
+    }
+    if (!features.avx512f || !features.avx512bw || !features.avx512vl) {
+        return CpuLevel::avx2;
+    }
+    return CpuLevel::avx512;
+#elif defined(BIGINT_WORDS)
+    (void)features;
+    return CpuLevel::words;
+#else
+    (void)features;
+    return CpuLevel::generic;
+#endif
+
+}
+
+const char* cpu_level_name(CpuLevel level) {
+
+    switch (level) {
+    case CpuLevel::generic: return "generic";
+    case CpuLevel::words: return "words";
+    case CpuLevel::bmi2: return "bmi2";
+    case CpuLevel::avx2: return "avx2";
+    case CpuLevel::avx512: return "avx512";
+    }
+    return "";
+
+}
+
+// the kernels every public kernel forwards to
+struct LimbKernels {
+    int (*compare)(LimbSpan<const limb>, LimbSpan<const limb>);
+    limb (*add)(LimbSpan<limb>, LimbSpan<const limb>, LimbSpan<const limb>);
+    limb (*sub)(LimbSpan<limb>, LimbSpan<const limb>, LimbSpan<const limb>);
+    limb (*mul_limb)(LimbSpan<limb>, LimbSpan<const limb>, limb, limb);
+    limb (*addmul_limb)(LimbSpan<limb>, LimbSpan<const limb>, limb);
+    void (*mul)(LimbSpan<limb>, LimbSpan<const limb>, LimbSpan<const limb>);
+    void (*sqr)(LimbSpan<limb>, LimbSpan<const limb>);
+    void (*divmod)(LimbSpan<limb>, LimbSpan<limb>, LimbSpan<const limb>, LimbSpan<const limb>);
+    void (*bit_and)(LimbSpan<limb>, LimbSpan<const limb>, LimbSpan<const limb>);
+    void (*bit_or)(LimbSpan<limb>, LimbSpan<const limb>, LimbSpan<const limb>);
+    void (*bit_xor)(LimbSpan<limb>, LimbSpan<const limb>, LimbSpan<const limb>);
+    void (*bit_not)(LimbSpan<limb>, LimbSpan<const limb>);
+    limb (*shl)(LimbSpan<limb>, LimbSpan<const limb>, _ui);
+    limb (*shr)(LimbSpan<limb>, LimbSpan<const limb>, _ui);
+};
+
+// fastest kernels using nothing past level
+LimbKernels _kernels_for(CpuLevel level) {
+
+    LimbKernels res;
+    res.compare = _compare_limbs_generic;
+    res.add = _add_limbs_generic;
+    res.sub = _sub_limbs_generic;
+    res.mul_limb = _mul_limb_generic;
+    res.addmul_limb = _addmul_limb_generic;
+    res.mul = _mul_limbs_generic;
+    res.sqr = _sqr_limbs_generic;
+    res.divmod = _divmod_limbs_generic;
+    res.bit_and = _bitwise_limbs_generic<_BitOp::bit_and>;
+    res.bit_or = _bitwise_limbs_generic<_BitOp::bit_or>;
+    res.bit_xor = _bitwise_limbs_generic<_BitOp::bit_xor>;
+    res.bit_not = _not_limbs_generic;
+    res.shl = _shl_limbs_generic;
+    res.shr = _shr_limbs_generic;
+#if defined(BIGINT_WORDS)
+    if (level >= CpuLevel::words) {
+        res.mul = _mul_limbs_words;
+        res.sqr = _sqr_limbs_words;
+    }
+#endif
+#if defined(BIGINT_X86_64)
+    if (level >= CpuLevel::bmi2) {
+        res.mul = _mul_limbs_mulx;
+        res.sqr = _sqr_limbs_mulx;
+    }
+    if (level >= CpuLevel::avx2) {
+        res.compare = _compare_limbs_avx2;
+        res.bit_and = _bitwise_limbs_avx2<_BitOp::bit_and>;
+        res.bit_or = _bitwise_limbs_avx2<_BitOp::bit_or>;
+        res.bit_xor = _bitwise_limbs_avx2<_BitOp::bit_xor>;
+        res.bit_not = _not_limbs_avx2;
+        res.shl = _shl_limbs_avx2;
+        res.shr = _shr_limbs_avx2;
+    }
+    if (level >= CpuLevel::avx512) {
+        res.compare = _compare_limbs_avx512;
+        res.mul_limb = _mul_limb_avx512;
+        res.addmul_limb = _addmul_limb_avx512;
+        res.bit_and = _bitwise_limbs_avx512<_BitOp::bit_and>;
+        res.bit_or = _bitwise_limbs_avx512<_BitOp::bit_or>;
+        res.bit_xor = _bitwise_limbs_avx512<_BitOp::bit_xor>;
+        res.bit_not = _not_limbs_avx512;
+        res.shl = _shl_limbs_avx512;
+        res.shr = _shr_limbs_avx512;
+        if (cpu_features().avx512ifma) {
+            res.mul = _mul_limbs_ifma;
+        }
+    }
+#endif
+    return res;
+
+}
+
+struct _KernelState {
+    CpuLevel level;
+    LimbKernels kernels;
+};
+
+// environment variable BIGINT_CPU set to the name of a level caps the level used, for benchmarking
+// a level above what the cpu supports is lowered to the supported one
+inline _KernelState& _kernel_state() {
+
+    static _KernelState state = [] {
+        CpuLevel level = cpu_level_supported();
+        if (const char* env = std::getenv("BIGINT_CPU")) {
+            for (auto want : {CpuLevel::generic, CpuLevel::words, CpuLevel::bmi2, CpuLevel::avx2, CpuLevel::avx512}) {
+                if (std::strcmp(env, cpu_level_name(want)) == 0) {
+                    level = std::min(level, want);
+                }
+            }
+        }
+        return _KernelState{level, _kernels_for(level)};
+    }();
+    return state;
+
+}
+
+// level of the kernels in use
+CpuLevel cpu_level() {
+
+    return _kernel_state().level;
+
+}
+
+// use the kernels of level, returns false and changes nothing if the cpu does not support it
+// not thread safe, only call while no other thread is using the library
+bool set_cpu_level(CpuLevel level) {
+
+    if (level > cpu_level_supported()) {
+        return false;
+    }
+    _kernel_state() = _KernelState{level, _kernels_for(level)};
+    return true;
+
+}
+
+// negative if l < r, 0 if l == r, positive if l > r
+int compare_limbs(LimbSpan<const limb> l, LimbSpan<const limb> r) {
+
+    return _kernel_state().kernels.compare(l, r);
+
+}
+
+// res = l + r, returns the carry out of the most significant digit
+// requires res.size() == max(l.size(), r.size())
+// res may be the same memory as l or r
+limb add_limbs(LimbSpan<limb> res, LimbSpan<const limb> l, LimbSpan<const limb> r) {
+
+    return _kernel_state().kernels.add(res, l, r);
+
+}
+
+// res = l - r, returns 1 if a borrow was needed past the most significant digit (l < r)
+// requires l.size() >= r.size() and res.size() == l.size()
+// res may be the same memory as l or r
+limb sub_limbs(LimbSpan<limb> res, LimbSpan<const limb> l, LimbSpan<const limb> r) {
+
+    return _kernel_state().kernels.sub(res, l, r);
+
+}
+
+// res = l * digit + carry, returns the digit carried out of the most significant digit
+// requires res.size() == l.size() and digit, carry < BASE
+// res may be the same memory as l
+limb mul_limb(LimbSpan<limb> res, LimbSpan<const limb> l, const limb digit, limb carry = 0) {
+
+    return _kernel_state().kernels.mul_limb(res, l, digit, carry);
+
+}
+
+// res += l * digit, returns the digit carried out of the most significant digit
+// requires res.size() == l.size() and digit < BASE
+// res must be the same memory as l or not overlap it
+limb addmul_limb(LimbSpan<limb> res, LimbSpan<const limb> l, const limb digit) {
+
+    return _kernel_state().kernels.addmul_limb(res, l, digit);
+
+}
+
+// res = l * r
+// requires res.size() == l.size() + r.size()
+// res must not overlap l or r
+void mul_limbs(LimbSpan<limb> res, LimbSpan<const limb> l, LimbSpan<const limb> r) {
+
+    _kernel_state().kernels.mul(res, l, r);
+
+}
+
+// res = num * num
+// requires res.size() == 2 * num.size()
+// res must not overlap num
+void sqr_limbs(LimbSpan<limb> res, LimbSpan<const limb> num) {
+
+    _kernel_state().kernels.sqr(res, num);
+
+}
+
+// q = n / d, r = n % d
+// requires d.front() != 0, n.size() >= d.size(), q.size() == n.size() - d.size() + 1
+// and r.size() == d.size()
+// q and r must not overlap n or d
+void divmod_limbs(LimbSpan<limb> q, LimbSpan<limb> r, LimbSpan<const limb> n, LimbSpan<const limb> d) {
+
+    _kernel_state().kernels.divmod(q, r, n, d);
+
+}
+
+// res = l & r, l | r and l ^ r digit by digit
+// requires res.size() == l.size() == r.size()
+// res may be the same memory as l or r
+void and_limbs(LimbSpan<limb> res, LimbSpan<const limb> l, LimbSpan<const limb> r) {
+
+    _kernel_state().kernels.bit_and(res, l, r);
+
+}
+
+void or_limbs(LimbSpan<limb> res, LimbSpan<const limb> l, LimbSpan<const limb> r) {
+
+    _kernel_state().kernels.bit_or(res, l, r);
+
+}
+
+void xor_limbs(LimbSpan<limb> res, LimbSpan<const limb> l, LimbSpan<const limb> r) {
+
+    _kernel_state().kernels.bit_xor(res, l, r);
+
+}
+
+// res = BASE - 1 - num digit by digit, every bit of every digit flipped
+// requires res.size() == num.size()
+// res may be the same memory as num
+void not_limbs(LimbSpan<limb> res, LimbSpan<const limb> num) {
+
+    _kernel_state().kernels.bit_not(res, num);
+
+}
+
+// res = num << bits without what moves past the most significant digit, which is returned
+// requires bits < BASE_BIN_LENGTH and res.size() == num.size()
+// res may be the same memory as num
+limb shl_limbs(LimbSpan<limb> res, LimbSpan<const limb> num, const _ui bits) {
+
+    return _kernel_state().kernels.shl(res, num, bits);
+
+}
+
+// res = num >> bits, returns the bits moved out of the least significant digit
+// requires bits < BASE_BIN_LENGTH and res.size() == num.size()
+// res may be the same memory as num
+limb shr_limbs(LimbSpan<limb> res, LimbSpan<const limb> num, const _ui bits) {
+
+    return _kernel_state().kernels.shr(res, num, bits);
+
+}
+
+// Thread pool
+//
+// a job is a number of independent tasks, and any free thread takes the next task of the
+// newest job, so idle workers steal work from whoever posted it
+// the thread posting a job runs tasks too, and while waiting for it to finish runs only tasks
+// of it or of jobs posted from inside its tasks, so tasks can post jobs of their own without
+// deadlocking, and a waiting thread never runs unrelated work while holding its own locks
+
+class _ThreadPool {
+public:
+
+    explicit _ThreadPool(_ui threads) : stopping(false) {
+
+        for (_ui i = 1; i < threads; ++i) {
+            workers.emplace_back([this]() {
+                std::unique_lock<std::mutex> guard(lock);
+                while (!stopping) {
+                    if (!_run_one(guard, nullptr)) {
+                        wake.wait(guard);
+                    }
+                }
+            });
+        }
+
+    }
+
+    _ThreadPool(const _ThreadPool&) = delete;
+    _ThreadPool& operator= (const _ThreadPool&) = delete;
+
+    ~_ThreadPool() {
+
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+    }
+
+    // threads work is spread over, counting the calling thread
+    _ui threads() const { return static_cast<_ui>(workers.size() + 1); }
+
+    // task(i) for every i in [0, count), returns once all are done
+    // the first exception thrown by a task is thrown again here
+    template<typename Task>
+    void run(std::size_t count, Task&& task) {
+
+        if (workers.empty() || count <= 1) {
+            for (std::size_t i = 0; i != count; ++i) {
+                task(i);
+            }
+            return;
+        }
+
+        _Job job{task, count, 0, 0, nullptr, _current()};
+        std::unique_lock<std::mutex> guard(lock);
+        jobs.push_back(&job);
+        wake.notify_all();
+        while (job.done != job.count) {
+            if (!_run_one(guard, &job)) {
+                wake.wait(guard);
+            }
+        }
+        if (job.error) {
+            std::rethrow_exception(job.error);
+        }
+
+    }
+
+private:
+
+    struct _Job {
+        std::function<void(std::size_t)> task;
+        std::size_t count;
+        std::size_t next; // first task not yet taken
+        std::size_t done;
+        std::exception_ptr error;
+        const _Job* parent; // job whose task posted this one, nullptr if none
+    };
+
+    // job whose task this thread is running, nullptr if none
+    static const _Job*& _current() {
+
+        thread_local const _Job* job = nullptr;
+        return job;
+
+    }
+
+    // true if job is within or was posted from inside its tasks, at any depth
+    static bool _nested(const _Job* job, const _Job* within) {
+
+        for (; job != nullptr; job = job->parent) {
+            if (job == within) {
+                return true;
+            }
+        }
+        return false;
+
+    }
+
+    // run the next task of the newest job with tasks left that is nested in within, any job
+    // if within is nullptr, false if there is none
+    // guard is unlocked while the task runs
+    bool _run_one(std::unique_lock<std::mutex>& guard, const _Job* within) {
+
+        auto iter = std::find_if(jobs.rbegin(), jobs.rend(), [within](const _Job* job) {
+            return within == nullptr || _nested(job, within);
+        });
+        if (iter == jobs.rend()) {
+            return false;
+        }
+        _Job& job = **iter;
+        const std::size_t i = job.next++;
+        if (job.next == job.count) {
+            jobs.erase(std::next(iter).base());
+        }
+
+        guard.unlock();
+        const _Job* const outer = _current();
+        _current() = &job;
+        std::exception_ptr error;
+        try {
+            job.task(i);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        _current() = outer;
+        guard.lock();
+
+        if (error && !job.error) {
+            job.error = error;
+        }
+        if (++job.done == job.count) {
+            wake.notify_all();
+        }
+        return true;
+
+    }
+
+    std::mutex lock;
+    std::condition_variable wake;
+    std::vector<_Job*> jobs; // jobs with tasks not yet taken, newest last
+    std::vector<std::thread> workers;
+    bool stopping;
+
+};
+
+struct _ParallelState {
+    _ui threads;
+    std::size_t mul_digits;
+    std::size_t convert_digits;
+    std::unique_ptr<_ThreadPool> pool;
+};
+
+inline _ParallelState& _parallel_state() {
+
+    static _ParallelState state{0, 0, 0, nullptr};
+    return state;
+
+}
+
+// make the pool with state.threads threads, one per hardware thread if it is 0
+inline void _make_parallel_pool(_ParallelState& state) {
+
+    const _ui hardware = std::thread::hardware_concurrency();
+    state.pool = std::make_unique<_ThreadPool>(state.threads != 0 ? state.threads : std::max<_ui>(hardware, 1));
+
+}
+
+inline std::once_flag& _parallel_pool_made() {
+
+    static std::once_flag made;
+    return made;
+
+}
+
+// the pool, made on first use unless set_parallel_threads made it already
+inline _ThreadPool& _parallel_pool() {
+
+    auto& state = _parallel_state();
+    std::call_once(_parallel_pool_made(), [&state]() {
+        if (!state.pool) {
+            _make_parallel_pool(state);
+        }
+    });
+    return *state.pool;
+
+}
+
+// threads parallel work is spread over, counting the calling thread
+_ui parallel_threads() {
+
+    return _parallel_pool().threads();
+
+}
+
+// spread parallel work over threads threads, counting the calling thread, 0 for one per
+// hardware thread and 1 to keep all work on the calling thread
+// not thread safe, only call while no other thread is using the library
+void set_parallel_threads(_ui threads) {
+
+    auto& state = _parallel_state();
+    state.pool.reset(); // joins the old workers, if there were any
+    state.threads = threads;
+    std::call_once(_parallel_pool_made(), [&state]() {
+        _make_parallel_pool(state);
+    });
+    if (!state.pool) {
+        _make_parallel_pool(state); // the pool was made before, and just dropped
+    }
+
+}
+
+// Parallel multiplication
+//
+// off unless set_parallel_mul_digits is called, products whose operands both have at least
+// that many digits are split into blocks of at least that many digits
+// a product is split into the products of blocks of the longer operand with the shorter one,
+// and a square into the squares of its blocks and the products of pairs of blocks
+// every block product is written on its own and added in at its place afterwards
+
+// products with both operands at least digits long are split between threads, 0 turns it off
+// not thread safe, only call while no other thread is using the library
+void set_parallel_mul_digits(std::size_t digits) {
+
+    _parallel_state().mul_digits = digits;
+
+}
+
+std::size_t parallel_mul_digits() {
+
+    return _parallel_state().mul_digits;
+
+}
+
+// res += part * BASE^shift
+// requires the sum to fit in res
+inline void _add_at(LimbSpan<limb> res, LimbSpan<const limb> part, std::size_t shift) {
+
+    std::size_t start = res.size() - shift - part.size();
+    auto place = res.subspan(start, part.size());
+    limb carry = add_limbs(place, place, part);
+    for (; carry != 0; --start) {
+        carry = ++res[start - 1] >> BASE_BIN_LENGTH;
+        res[start - 1] &= LIMB_MASK;
+    }
+
+}
+
+// ends[i] is where block i of a number with size digits ends, blocks are about equal
+inline std::vector<std::size_t> _block_ends(std::size_t size, std::size_t blocks) {
+
+    std::vector<std::size_t> ends(blocks);
+    for (std::size_t i = 0; i != blocks; ++i) {
+        ends[i] = size * (i + 1) / blocks;
+    }
+    return ends;
+
+}
+
+// res = l * r on the pool, false and nothing done if the product is too small to split
+// requires res.size() == l.size() + r.size()
+bool _parallel_mul(LimbSpan<limb> res, LimbSpan<const limb> l, LimbSpan<const limb> r) {
+
+    const std::size_t grain = parallel_mul_digits();
+    if (l.size() < r.size()) {
+        std::swap(l, r);
+    }
+    if (grain == 0 || r.size() < grain || l.size() < 2 * grain) {
+        return false;
+    }
+    _ThreadPool& pool = _parallel_pool();
+    const std::size_t blocks = std::min<std::size_t>(l.size() / grain, 2 * pool.threads());
+    if (blocks < 2) {
+        return false;
+    }
+
+    const auto ends = _block_ends(l.size(), blocks);
+    std::vector<std::vector<limb>> parts(blocks);
+    for (std::size_t i = 0; i != blocks; ++i) {
+        parts[i].resize(ends[i] - (i == 0 ? 0 : ends[i - 1]) + r.size());
+    }
+    pool.run(blocks, [&](std::size_t i) {
+        const std::size_t first = i == 0 ? 0 : ends[i - 1];
+        mul_limbs(parts[i], l.subspan(first, ends[i] - first), r);
+    });
+
+    std::fill(res.begin(), res.end(), 0);
+    for (std::size_t i = 0; i != blocks; ++i) {
+        _add_at(res, parts[i], l.size() - ends[i]);
+    }
+    return true;
+
+}
+
+// res = num * num on the pool, false and nothing done if the square is too small to split
+// requires res.size() == 2 * num.size()
+bool _parallel_sqr(LimbSpan<limb> res, LimbSpan<const limb> num) {
+
+    const std::size_t grain = parallel_mul_digits();
+    if (grain == 0 || num.size() < 2 * grain) {
+        return false;
+    }
+    _ThreadPool& pool = _parallel_pool();
+    // enough blocks that the pairs give every thread two products
+    std::size_t blocks = 2;
+    while (blocks * (blocks + 1) / 2 < 2 * pool.threads()) {
+        ++blocks;
+    }
+    blocks = std::min(blocks, num.size() / grain);
+    if (blocks < 2) {
+        return false;
+    }
+
+    const auto ends = _block_ends(num.size(), blocks);
+    auto block = [&](std::size_t i) {
+        const std::size_t first = i == 0 ? 0 : ends[i - 1];
+        return num.subspan(first, ends[i] - first);
+    };
+    // pairs (i, j) with i <= j, i == j being a square
+    std::vector<std::pair<std::size_t, std::size_t>> pairs;
+    for (std::size_t i = 0; i != blocks; ++i) {
+        for (std::size_t j = i; j != blocks; ++j) {
+            pairs.emplace_back(i, j);
+        }
+    }
+    std::vector<std::vector<limb>> parts(pairs.size());
+    for (std::size_t i = 0; i != pairs.size(); ++i) {
+        parts[i].resize(block(pairs[i].first).size() + block(pairs[i].second).size());
+    }
+    pool.run(pairs.size(), [&](std::size_t i) {
+        if (pairs[i].first == pairs[i].second) {
+            sqr_limbs(parts[i], block(pairs[i].first));
+        } else {
+            mul_limbs(parts[i], block(pairs[i].first), block(pairs[i].second));
+        }
+    });
+
+    // every product of two different blocks appears twice
+    std::fill(res.begin(), res.end(), 0);
+    for (std::size_t i = 0; i != pairs.size(); ++i) {
+        if (pairs[i].first != pairs[i].second) {
+            _add_at(res, parts[i], 2 * num.size() - ends[pairs[i].first] - ends[pairs[i].second]);
+        }
+    }
+    shl_limbs(res, res, 1);
+    for (std::size_t i = 0; i != pairs.size(); ++i) {
+        if (pairs[i].first == pairs[i].second) {
+            _add_at(res, parts[i], 2 * (num.size() - ends[pairs[i].first]));
+        }
+    }
+    return true;
+
+}
+
+std::ostream& operator<< (std::ostream& out, const BigUnsigned& num) {
+
+    std::copy(num.digits.cbegin(), num.digits.cend(), std::ostream_iterator<_ull>(out, ", "));
+    return out;
+
+}
+
+inline auto _longer(const BigUnsigned* const l, const BigUnsigned* const r) {
+
+    return std::max(l, r, [](auto l, auto r) {
+        return l->digits.size() < r->digits.size();
+    });
+
+}
+
+inline auto _shorter(const BigUnsigned* const l, const BigUnsigned* const r) {
+
+    return std::min(l, r, [](auto l, auto r) {
+        return l->digits.size() <= r->digits.size();
+    });
+
+}
+
+inline auto _longer_digits(const BigUnsigned* const l, const BigUnsigned* const r) {
+
+    return std::max(l, r, [](auto l, auto r) {
+        return l->digits.size() < r->digits.size();
+    })->digits;
+
+}
+
+inline auto _shorter_digits(const BigUnsigned* const l, const BigUnsigned* const r) {
+
+    return std::min(l, r, [](auto l, auto r) {
+        return l->digits.size() <= r->digits.size();
+    })->digits;
+
+}
+
+// negative if l < r, 0 if l == r, positive if l > r
+// numbers have no leading zeros, so a longer number is larger and only equal
+// lengths are compared digit by digit from the most significant
+int compare(const BigUnsigned& l, const BigUnsigned& r) {
+
+    if (l.digits.size() != r.digits.size()) {
+        return l.digits.size() < r.digits.size() ? -1 : 1;
+    }
+    return compare_limbs(l.digits, r.digits);
+
+}
+
+#if defined(__cpp_lib_three_way_comparison)
+std::strong_ordering operator<=> (const BigUnsigned& l, const BigUnsigned& r) {
+
+    return compare(l, r) <=> 0;
+
+}
+#endif
+
+bool operator== (const BigUnsigned& l, const BigUnsigned& r) {
+
+    return l.digits == r.digits;
+
+}
+
+bool operator!= (const BigUnsigned& l, const BigUnsigned& r) {
+
+    return !(l == r);
+
+}
+
+bool operator< (const BigUnsigned& l, const BigUnsigned& r) {
+
+    return compare(l, r) < 0;
+
+}
+
+bool operator> (const BigUnsigned& l, const BigUnsigned& r) {
+
+    return compare(l, r) > 0;
+
+}
+
+bool operator<= (const BigUnsigned& l, const BigUnsigned& r) {
+
+    return compare(l, r) <= 0;
+
+}
+
+bool operator>= (const BigUnsigned& l, const BigUnsigned& r) {
+
+    return compare(l, r) >= 0;
+
+}
+
+// Hashing
+//
+// wyhash style, two digits are packed into each 64 bit word and two words are
+// mixed with one 64 bit * 64 bit = 128 bit multiplication
+// the hash is not kept in the number since digits can be changed at any time
+
+constexpr std::uint64_t HASH_SECRET[4] = {0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull};
+
+// high and low halves of l * r xored together
+inline std::uint64_t _hash_mix(std::uint64_t l, std::uint64_t r) {
+
+#if defined(BIGINT_WORDS)
+    std::uint64_t high;
+    std::uint64_t low = _mul_words(l, r, high);
+    return low ^ high;
+#else
+    const std::uint64_t l_low = l & LIMB_MASK;
+    const std::uint64_t l_high = l >> BASE_BIN_LENGTH;
+    const std::uint64_t r_low = r & LIMB_MASK;
+    const std::uint64_t r_high = r >> BASE_BIN_LENGTH;
+    const std::uint64_t cross = (l_low * r_low >> BASE_BIN_LENGTH) + (l_high * r_low & LIMB_MASK) + (l_low * r_high & LIMB_MASK);
+    const std::uint64_t high = l_high * r_high + (l_high * r_low >> BASE_BIN_LENGTH) + (l_low * r_high >> BASE_BIN_LENGTH) + (cross >> BASE_BIN_LENGTH);
+    return (l * r) ^ high;
+#endif
+
+}
+
+// hash of the digits of num, equal digits hash equal however they are held
+std::uint64_t hash_limbs(LimbSpan<const limb> num, std::uint64_t seed = 0) {
+
+    const std::size_t len = num.size();
+    seed ^= _hash_mix(seed ^ HASH_SECRET[0], static_cast<std::uint64_t>(len) ^ HASH_SECRET[1]);
+
+    auto pack = [&](std::size_t i) {
+        return (static_cast<std::uint64_t>(i < len ? num[i] : 0) << BASE_BIN_LENGTH) | (i + 1 < len ? num[i + 1] : 0);
+    };
+
+    std::size_t i = 0;
+    for (; i + 4 <= len; i += 4) {
+        seed = _hash_mix(((num[i] << BASE_BIN_LENGTH) | num[i + 1]) ^ HASH_SECRET[1], ((num[i + 2] << BASE_BIN_LENGTH) | num[i + 3]) ^ seed);
+    }
+    if (i != len) {
+        seed = _hash_mix(pack(i) ^ HASH_SECRET[2], pack(i + 2) ^ seed);
+    }
+
+    return _hash_mix(seed ^ HASH_SECRET[3], static_cast<std::uint64_t>(len) ^ HASH_SECRET[0]);
+
+}
+
+namespace std {
+
+template<>
+struct hash<BigUnsigned> {
+
+    std::size_t operator() (const BigUnsigned& num) const noexcept {
+
+        return static_cast<std::size_t>(hash_limbs(num.digits));
+
+    }
+
+};
+
+// same value as for the BigUnsigned the digits came from
+template<>
+struct hash<BigUnsignedView> {
+
+    std::size_t operator() (const BigUnsignedView& view) const noexcept {
+
+        return static_cast<std::size_t>(hash_limbs(view));
+
+    }
+
+};
+
+}
+
+// theta(max(l.size, r.size))
+BigUnsigned operator+ (const BigUnsigned& l, const BigUnsigned& r) {
+
+    auto longer = ::_longer(&l, &r);
+
+    BigUnsigned result(zero_digits, longer->digits.size() + 1);
+    LimbSpan<limb> res_span(result.digits.data() + 1, longer->digits.size());
+    result.digits.front() = add_limbs(res_span, l.digits, r.digits);
+
+    result.resize_to_fit();
+
+    return result;
+
+}
+
+// |l - r|, sets swapped to whether l < r
+// digits above the first from the top where l and r differ are equal and give 0,
+// so finding it and subtracting below it together read each digit once
+BigUnsigned _abs_diff(const BigUnsigned& l, const BigUnsigned& r, bool& swapped) {
+
+    auto larger = &l;
+    auto smaller = &r;
+    std::size_t skip = 0;
+    if (l.digits.size() == r.digits.size()) {
+        auto diff = std::mismatch(l.digits.cbegin(), l.digits.cend(), r.digits.cbegin());
+        if (diff.first == l.digits.cend()) {
+            swapped = false;
+            return BigUnsigned();
+        }
+        if (*diff.first < *diff.second) {
+            std::swap(larger, smaller);
+        }
+        skip = static_cast<std::size_t>(diff.first - l.digits.cbegin());
+    } else if (l.digits.size() < r.digits.size()) {
+        std::swap(larger, smaller);
+    }
+    swapped = larger != &l;
+
+    BigUnsigned result(zero_digits, larger->digits.size() - skip);
+    sub_limbs(result.digits, LimbSpan<const limb>(larger->digits).subspan(skip), LimbSpan<const limb>(smaller->digits).subspan(skip));
+
+    result.resize_to_fit();
+
+    return result;
+
+}
+
+// theta(max(l.size, r.size))
+// note: doesnt care about order, the shorter number will be subtracted
+// from the longer one, and if same length then smaller from larger
+BigUnsigned operator- (const BigUnsigned& l, const BigUnsigned& r) {
+
+    bool swapped;
+    return _abs_diff(l, r, swapped);
+
+}
+
+// theta(l.size * r.size)
+// i dont care enough to use a fast multiplication algorithm since i dont care enough
+// if needed will implement
+BigUnsigned operator* (const BigUnsigned& l, const BigUnsigned& r) {
+
+    if (l.digits.empty() || r.digits.empty()) {
+        return BigUnsigned();
+    }
+
+    BigUnsigned res(zero_digits, l.digits.size() + r.digits.size());
+    if (&l == &r) {
+        if (!_parallel_sqr(res.digits, l.digits)) {
+            sqr_limbs(res.digits, l.digits);
+        }
+    } else if (!_parallel_mul(res.digits, l.digits, r.digits)) {
+        mul_limbs(res.digits, l.digits, r.digits);
+    }
+
+    res.resize_to_fit();
+
+    return res;
+
+}
+
+// Meant for positive only
+BigUnsigned divide_digit(typename BigUnsigned::cont_ull::const_iterator start, typename BigUnsigned::cont_ull::const_iterator end, const _ull digit) {
+
+    BigUnsigned res(zero_digits, static_cast<BigUnsigned::sz_ty_ull>(std::distance(start, end)));
+    if (start != end) {
+        divmod_limb(res.digits, LimbSpan<const limb>(std::addressof(*start), res.digits.size()), digit);
+    }
+
+    res.resize_to_fit();
+
+    return res;
+
+}
+
+BigUnsigned divide(const BigUnsigned* const remainder, const BigUnsigned* const denom, const _ull digit) {
+
+    return divide_digit(remainder->digits.cbegin(), remainder->digits.cbegin() + (remainder->digits.size() - denom->digits.size() + 1), digit);
+
+}
+
+// theta((n.size - d.size) * d.size)
+// returns quotient and remainder
+// Note: d must not be 0
+std::pair<BigUnsigned, BigUnsigned> divmod(const BigUnsigned& n, const BigUnsigned& d) {
+
+    if (n.digits.size() < d.digits.size()) {
+        return {BigUnsigned(), n};
+    }
+
+    BigUnsigned q(zero_digits, n.digits.size() - d.digits.size() + 1);
+    BigUnsigned r(zero_digits, d.digits.size());
+    divmod_limbs(q.digits, r.digits, n.digits, d.digits);
+
+    q.resize_to_fit();
+    r.resize_to_fit();
+
+    return {std::move(q), std::move(r)};
+
+}
+
+// Note: d must not be 0
+BigUnsigned operator/ (const BigUnsigned& n, const BigUnsigned& d) {
+
+    return divmod(n, d).first;
+
+}
+
+// Note: d must not be 0
+BigUnsigned operator% (const BigUnsigned& n, const BigUnsigned& d) {
+
+    return divmod(n, d).second;
+
+}
+
+// Native integer conversion
+
+// true if num can be held by a 64 bit unsigned integer
+bool fits_u64(const BigUnsigned& num) {
+
+    return num.digits.size() * BASE_BIN_LENGTH <= 64;
+
+}
+
+// num as a 64 bit unsigned integer
+// throws std::overflow_error if it does not fit, check with fits_u64
+std::uint64_t to_u64(const BigUnsigned& num) {
+
+    if (!fits_u64(num)) {
+        throw std::overflow_error("BigUnsigned does not fit in 64 bits");
+    }
+
+    std::uint64_t res = 0;
+    for (auto digit : num.digits) {
+        res = (res << BASE_BIN_LENGTH) | digit;
+    }
+    return res;
+
+}
+
+// Mixed arithmetic with a native integer
+//
+// one pass over the digits of l, no BigUnsigned is made for r
+// compound forms stop as soon as there is nothing left to carry or borrow
+
+// digits of r, most significant first, at most 2
+inline BigUnsigned::cont_ull::size_type _native_digits(_ull r, limb (&out)[2]) {
+
+    out[0] = r >> BASE_BIN_LENGTH;
+    out[1] = r & LIMB_MASK;
+    return out[0] != 0 ? 2 : (out[1] != 0 ? 1 : 0);
+
+}
+
+BigUnsigned& operator+= (BigUnsigned& l, _ull r) {
+
+    limb r_digits[2];
+    auto r_len = _native_digits(r, r_digits);
+    if (l.digits.size() < r_len) {
+        l.digits.insert(l.digits.cbegin(), r_len - l.digits.size(), 0);
+    }
+
+    limb carry = 0;
+    auto iter = l.digits.end();
+    for (auto r_iter = r_digits + 2; r_iter != r_digits + (2 - r_len); ) {
+        --iter;
+        limb sum = *iter + *--r_iter + carry;
+        carry = sum >> BASE_BIN_LENGTH;
+        *iter = sum & LIMB_MASK;
+    }
+    while (carry != 0 && iter != l.digits.begin()) {
+        --iter;
+        limb sum = *iter + carry;
+        carry = sum >> BASE_BIN_LENGTH;
+        *iter = sum & LIMB_MASK;
+    }
+    if (carry != 0) {
+        l.digits.insert(l.digits.cbegin(), carry);
+    }
+
+    return l;
+
+}
+
+// note: doesnt care about order, same as subtracting two BigUnsigned
+BigUnsigned& operator-= (BigUnsigned& l, _ull r) {
+
+    limb r_digits[2];
+    auto r_len = _native_digits(r, r_digits);
+    if (compare_limbs(l.digits, LimbSpan<const limb>(r_digits + (2 - r_len), r_len)) < 0) {
+        l = BigUnsigned(r - to_u64(l));
+        return l;
+    }
+
+    limb borrow = 0;
+    auto iter = l.digits.end();
+    for (auto r_iter = r_digits + 2; r_iter != r_digits + (2 - r_len); ) {
+        --iter;
+        limb diff = *iter - *--r_iter - borrow;
+        borrow = diff >> (std::numeric_limits<limb>::digits - 1);
+        *iter = diff & LIMB_MASK;
+    }
+    while (borrow != 0) { // l >= r so stops before running out of digits
+        --iter;
+        limb diff = *iter - borrow;
+        borrow = diff >> (std::numeric_limits<limb>::digits - 1);
+        *iter = diff & LIMB_MASK;
+    }
+
+    l.resize_to_fit();
+
+    return l;
+
+}
+
+BigUnsigned& operator*= (BigUnsigned& l, _ull r) {
+
+    limb r_digits[2];
+    auto r_len = _native_digits(r, r_digits);
+    if (r_len == 0 || l.digits.empty()) {
+        l.digits.clear();
+    } else if (r_len == 1) {
+        limb carry = mul_limb(l.digits, l.digits, r_digits[1]);
+        if (carry != 0) {
+            l.digits.insert(l.digits.cbegin(), carry);
+        }
+    } else {
+        BigUnsigned res(zero_digits, l.digits.size() + 2);
+        mul_limbs(res.digits, l.digits, LimbSpan<const limb>(r_digits, 2));
+        res.resize_to_fit();
+        l = std::move(res);
+    }
+
+    return l;
+
+}
+
+BigUnsigned operator+ (BigUnsigned l, _ull r) {
+
+    return l += r;
+
+}
+
+BigUnsigned operator+ (_ull l, BigUnsigned r) {
+
+    return r += l;
+
+}
+
+BigUnsigned operator- (BigUnsigned l, _ull r) {
+
+    return l -= r;
+
+}
+
+BigUnsigned operator- (_ull l, BigUnsigned r) {
+
+    return r -= l;
+
+}
+
+BigUnsigned operator* (BigUnsigned l, _ull r) {
+
+    return l *= r;
+
+}
+
+BigUnsigned operator* (_ull l, BigUnsigned r) {
+
+    return r *= l;
+
+}
+
+// Bit operations
+//
+// bit 0 is the least significant bit, a number has no fixed width so
+// ~num only flips the bits below bit_length(num)
+
+// number of bits needed to write num, 0 for 0
+_ull _bit_length(LimbSpan<const limb> num) {
+
+    num = _strip_zeros(num);
+    if (num.empty()) {
+        return 0;
+    }
+
+    _ull res = static_cast<_ull>(num.size() - 1) * BASE_BIN_LENGTH;
+    for (limb top = num.front(); top != 0; top >>= 1) {
+        ++res;
+    }
+    return res;
+
+}
+
+// bit pos of num, bit 0 is least significant
+bool _test_bit(LimbSpan<const limb> num, _ull pos) {
+
+    auto index = pos / BASE_BIN_LENGTH;
+    if (index >= num.size()) {
+        return false;
+    }
+    return (num[num.size() - 1 - index] >> (pos % BASE_BIN_LENGTH)) & 1;
+
+}
+
+inline _ui _trailing_zeros(limb digit) {
+
+#if defined(__GNUC__)
+    return static_cast<_ui>(__builtin_ctzll(digit));
+#else
+    _ui res = 0;
+    for (; (digit & 1) == 0; digit >>= 1) {
+        ++res;
+    }
+    return res;
+#endif
+
+}
+
+inline _ui _popcount(limb digit) {
+
+#if defined(__GNUC__)
+    return static_cast<_ui>(__builtin_popcountll(digit));
+#else
+    digit = digit - ((digit >> 1) & 0x5555555555555555ull);
+    digit = (digit & 0x3333333333333333ull) + ((digit >> 2) & 0x3333333333333333ull);
+    digit = (digit + (digit >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return static_cast<_ui>((digit * 0x0101010101010101ull) >> 56);
+#endif
+
+}
+
+// number of bits needed to write num, 0 for 0
+_ull bit_length(const BigUnsigned& num) {
+
+    return _bit_length(num.digits);
+
+}
+
+// number of set bits
+_ull popcount(const BigUnsigned& num) {
+
+    _ull res = 0;
+    for (auto digit : num.digits) {
+        res += _popcount(digit);
+    }
+    return res;
+
+}
+
+// number of 0 bits below the lowest set bit, 0 for 0
+_ull count_trailing_zeros(const BigUnsigned& num) {
+
+    _ull res = 0;
+    for (auto iter = num.digits.crbegin(); iter != num.digits.crend(); ++iter, res += BASE_BIN_LENGTH) {
+        if (*iter != 0) {
+            return res + _trailing_zeros(*iter);
+        }
+    }
+    return 0;
+
+}
+
+bool test_bit(const BigUnsigned& num, _ull pos) {
+
+    return _test_bit(num.digits, pos);
+
+}
+
+// set bit pos of num to value, growing num as needed
+void set_bit(BigUnsigned& num, _ull pos, bool value = true) {
+
+    const auto index = pos / BASE_BIN_LENGTH;
+    const limb bit = limb(1) << (pos % BASE_BIN_LENGTH);
+    if (value) {
+        if (index >= num.digits.size()) {
+            num.digits.insert(num.digits.cbegin(), index + 1 - num.digits.size(), 0);
+        }
+        num.digits[num.digits.size() - 1 - index] |= bit;
+    } else if (index < num.digits.size()) {
+        num.digits[num.digits.size() - 1 - index] &= ~bit;
+        num.resize_to_fit();
+    }
+
+}
+
+// theta(num.size)
+BigUnsigned& operator<<= (BigUnsigned& num, _ull bits) {
+
+    if (num.digits.empty()) {
+        return num;
+    }
+
+    limb out = shl_limbs(num.digits, num.digits, static_cast<_ui>(bits % BASE_BIN_LENGTH));
+    if (out != 0) {
+        num.digits.insert(num.digits.cbegin(), out);
+    }
+    num.digits.resize(num.digits.size() + (bits / BASE_BIN_LENGTH), 0);
+
+    return num;
+
+}
+
+// theta(num.size)
+BigUnsigned& operator>>= (BigUnsigned& num, _ull bits) {
+
+    const auto whole = bits / BASE_BIN_LENGTH;
+    if (whole >= num.digits.size()) {
+        num.digits.clear();
+        return num;
+    }
+
+    num.digits.resize(num.digits.size() - whole);
+    shr_limbs(num.digits, num.digits, static_cast<_ui>(bits % BASE_BIN_LENGTH));
+    if (num.digits.front() == 0) { // at most the top digit emptied
+        num.digits.erase(num.digits.cbegin());
+    }
+
+    return num;
+
+}
+
+BigUnsigned operator<< (BigUnsigned num, _ull bits) {
+
+    return num <<= bits;
+
+}
+
+BigUnsigned operator>> (BigUnsigned num, _ull bits) {
+
+    return num >>= bits;
+
+}
+
+// theta(min(l.size, r.size)), digits of the longer number above the shorter are 0 in the result
+BigUnsigned operator& (const BigUnsigned& l, const BigUnsigned& r) {
+
+    auto shorter = ::_shorter(&l, &r);
+    auto len = shorter->digits.size();
+
+    BigUnsigned res(zero_digits, len);
+    and_limbs(res.digits, LimbSpan<const limb>(l.digits).last(len), LimbSpan<const limb>(r.digits).last(len));
+
+    res.resize_to_fit();
+
+    return res;
+
+}
+
+BigUnsigned& operator&= (BigUnsigned& l, const BigUnsigned& r) {
+
+    auto len = std::min(l.digits.size(), r.digits.size());
+    LimbSpan<limb> low = LimbSpan<limb>(l.digits).last(len);
+    and_limbs(low, low, LimbSpan<const limb>(r.digits).last(len));
+    l.digits.erase(l.digits.cbegin(), l.digits.cend() - len);
+
+    l.resize_to_fit();
+
+    return l;
+
+}
+
+// theta(max(l.size, r.size))
+BigUnsigned& operator|= (BigUnsigned& l, const BigUnsigned& r) {
+
+    auto len = r.digits.size();
+    if (l.digits.size() < len) {
+        l.digits.insert(l.digits.cbegin(), len - l.digits.size(), 0);
+    }
+    LimbSpan<limb> low = LimbSpan<limb>(l.digits).last(len);
+    or_limbs(low, low, r.digits);
+
+    return l;
+
+}
+
+// theta(max(l.size, r.size))
+BigUnsigned& operator^= (BigUnsigned& l, const BigUnsigned& r) {
+
+    auto len = r.digits.size();
+    if (l.digits.size() < len) {
+        l.digits.insert(l.digits.cbegin(), len - l.digits.size(), 0);
+    }
+    LimbSpan<limb> low = LimbSpan<limb>(l.digits).last(len);
+    xor_limbs(low, low, r.digits);
+
+    l.resize_to_fit();
+
+    return l;
+
+}
+
+BigUnsigned operator| (const BigUnsigned& l, const BigUnsigned& r) {
+
+    auto res = *::_longer(&l, &r);
+    return res |= *::_shorter(&l, &r);
+
+}
+
+BigUnsigned operator^ (const BigUnsigned& l, const BigUnsigned& r) {
+
+    auto res = *::_longer(&l, &r);
+    return res ^= *::_shorter(&l, &r);
+
+}
+
+// theta(num.size)
+BigUnsigned operator~ (BigUnsigned num) {
+
+    if (num.digits.empty()) {
+        return num;
+    }
+
+    const _ull top_bits = _bit_length(LimbSpan<const limb>(num.digits).first(1));
+    not_limbs(num.digits, num.digits);
+    num.digits.front() &= (limb(1) << top_bits) - 1;
+
+    num.resize_to_fit();
+
+    return num;
+
+}
+
+// Montgomery multiplication
+//
+// for many products modulo the same odd m, x is held as x * R mod m and l * r / R mod m
+// only needs multiples of m added and digits shifted away, no division
+// R = BASE^n with n the digits of m rounded up to even, so R is the same when digits
+// are worked on in pairs as 64 bit words
+
+// -m^-1 mod 2^64, m must be odd
+// m * m = 1 mod 8 and every newton step doubles the bits that are right
+inline std::uint64_t _mont_inverse(std::uint64_t m) {
+
+    std::uint64_t inv = m;
+    for (_ui i = 0; i != 5; ++i) {
+        inv *= 2 - m * inv;
+    }
+    return 0 - inv;
+
+}
+
+// res = t / R mod m, t holds a product of two numbers below m in 2 * m.size() + 1 digits,
+// its most significant digit 0, and is overwritten
+// each step adds the multiple of m making the least significant digit 0, leaving t < 2 * m
+void _mont_reduce_generic(LimbSpan<limb> res, LimbSpan<limb> t, LimbSpan<const limb> m, const limb m_inv) {
+
+    const std::size_t n = m.size();
+    for (std::size_t low = 2 * n; low != n; --low) {
+        const limb digit = (t[low] * m_inv) & LIMB_MASK;
+        limb carry = addmul_limb(t.subspan(low - n + 1, n), m, digit);
+        for (std::size_t i = low - n; carry != 0; --i) {
+            carry += t[i];
+            t[i] = carry & LIMB_MASK;
+            carry >>= BASE_BIN_LENGTH;
+        }
+    }
+
+    auto top = t.first(n + 1);
+    if (top.front() != 0 || compare_limbs(top.subspan(1), m) >= 0) {
+        sub_limbs(top, top, m);
+    }
+    std::copy(top.begin() + 1, top.end(), res.begin());
+
+}
+
+#if defined(BIGINT_WORDS)
+// returns the low word of l * r + a + b, high is set to the high word, the sum can not overflow
+inline std::uint64_t _muladd_words(std::uint64_t l, std::uint64_t r, std::uint64_t a, std::uint64_t b, std::uint64_t& high) {
+
+#if defined(__SIZEOF_INT128__)
+    _u128 full = static_cast<_u128>(l) * r + a + b;
+    high = static_cast<std::uint64_t>(full >> 64);
+    return static_cast<std::uint64_t>(full);
+#else
+    std::uint64_t low = _mul_words(l, r, high);
+    high += _add_words(0, low, a, low);
+    high += _add_words(0, low, b, low);
+    return low;
+#endif
+
+}
+
+// t_64 -= m_64 if t_64 is not below m_64, t_64 is words + 1 words and m_64 words words
+inline void _mont_sub_words(std::uint64_t* t_64, const std::uint64_t* m_64, std::size_t words) {
+
+    bool larger = t_64[words] != 0;
+    if (!larger) {
+        std::size_t i = words;
+        while (i != 0 && t_64[i - 1] == m_64[i - 1]) {
+            --i;
+        }
+        larger = i == 0 || t_64[i - 1] > m_64[i - 1];
+    }
+    if (larger) {
+        unsigned char carry = 1;
+        for (std::size_t i = 0; i != words; ++i) {
+            carry = _add_words(carry, t_64[i], ~m_64[i], t_64[i]);
+        }
+    }
+
+}
+
+// t_64 = l_64 * r_64 / R mod m on 64 bit words, least significant first
+// t_64 is words + 1 words of 0
+// one pass per word of r_64 adds l_64 times it and the multiple of m_64 making the least
+// significant word 0, then moves every word down one, so t_64 is only loaded and stored once
+inline void _mont_mul_words_fios(std::uint64_t* t_64, const std::uint64_t* l_64, const std::uint64_t* r_64,
+    const std::uint64_t* m_64, std::size_t words, std::uint64_t m_inv) {
+
+    for (std::size_t i = 0; i != words; ++i) {
+        const std::uint64_t digit = r_64[i];
+        std::uint64_t carry_l;
+        std::uint64_t carry_m;
+        const std::uint64_t low = _muladd_words(l_64[0], digit, t_64[0], 0, carry_l);
+        const std::uint64_t q = low * m_inv;
+        _muladd_words(m_64[0], q, low, 0, carry_m); // low word is 0
+        for (std::size_t j = 1; j != words; ++j) {
+            const std::uint64_t word = _muladd_words(l_64[j], digit, t_64[j], carry_l, carry_l);
+            t_64[j - 1] = _muladd_words(m_64[j], q, word, carry_m, carry_m);
+        }
+        unsigned char carry = _add_words(0, t_64[words], carry_l, t_64[words - 1]);
+        carry += _add_words(0, t_64[words - 1], carry_m, t_64[words - 1]);
+        t_64[words] = carry; // t_64 < 2 * m_64 after every pass
+    }
+    _mont_sub_words(t_64, m_64, words);
+
+}
+
+// t_64 = num_64 * num_64 / R mod m, t_64 is 2 * words + 1 words of 0
+// squares are made first and reduced after, which makes half the products of _mont_mul_words_fios
+// the result is left in the words [words, 2 * words) of t_64
+template<bool Mulx>
+inline void _mont_sqr_words(std::uint64_t* t_64, const std::uint64_t* num_64, const std::uint64_t* m_64, std::size_t words, std::uint64_t m_inv) {
+
+    _sqr_words_rows<Mulx>(t_64, num_64, words);
+    for (std::size_t i = 0; i != words; ++i) {
+        std::uint64_t carry = _addmul_words<Mulx>(t_64 + i, m_64, words, t_64[i] * m_inv);
+        for (std::size_t j = i + words; carry != 0; ++j) {
+            carry = _add_words(0, t_64[j], carry, t_64[j]);
+        }
+    }
+    _mont_sub_words(t_64 + words, m_64, words);
+
+}
+
+// res = l * r / R mod m with digits packed into words, the product of l and itself is a square
+// scratch is 4 * words + 1 words
+template<bool Mulx>
+inline void _mont_mul_words_impl(LimbSpan<limb> res, LimbSpan<const limb> l, LimbSpan<const limb> r,
+    const std::uint64_t* m_64, std::uint64_t m_inv, std::uint64_t* scratch) {
+
+    const std::size_t words = res.size() / 2;
+    auto l_64 = scratch;
+    auto r_64 = l_64 + words;
+    auto t_64 = r_64 + words;
+    _pack_words(l, l_64, words);
+    if (l.data() == r.data()) {
+        std::fill(t_64, t_64 + 2 * words + 1, 0);
+        _mont_sqr_words<Mulx>(t_64, l_64, m_64, words, m_inv);
+        _unpack_words(t_64 + words, res);
+    } else {
+        std::fill(t_64, t_64 + words + 1, 0);
+        _pack_words(r, r_64, words);
+        _mont_mul_words_fios(t_64, l_64, r_64, m_64, words, m_inv);
+        _unpack_words(t_64, res);
+    }
+
+}
+
+void _mont_mul_words(LimbSpan<limb> res, LimbSpan<const limb> l, LimbSpan<const limb> r,
+    const std::uint64_t* m_64, std::uint64_t m_inv, std::uint64_t* scratch) {
+
+    _mont_mul_words_impl<false>(res, l, r, m_64, m_inv, scratch);
+
+}
+#endif
+
+#if defined(BIGINT_X86_64)
+BIGINT_TARGET("bmi2,adx")
+void _mont_mul_mulx(LimbSpan<limb> res, LimbSpan<const limb> l, LimbSpan<const limb> r,
+    const std::uint64_t* m_64, std::uint64_t m_inv, std::uint64_t* scratch) {
+
+    _mont_mul_words_impl<true>(res, l, r, m_64, m_inv, scratch);
+
+}
+#endif
+
+// arithmetic modulo a fixed odd m on residues, x * R mod m held in size() digits
+// every buffer is made by the constructor, so operations on residues allocate nothing
+// residue arguments are size() digits below m and may be the same memory as the result
+// not thread safe, every thread needs its own context
+class MontgomeryContext {
+public:
+
+    // throws std::invalid_argument if mod is even
+    explicit MontgomeryContext(const BigUnsigned& mod) : modulus_(mod) {
+
+        if (mod.digits.empty() || mod.digits.back() % 2 == 0) {
+            throw std::invalid_argument("MontgomeryContext modulus must be odd");
+        }
+
+        m.assign(mod.digits.size() + mod.digits.size() % 2, 0);
+        std::copy(mod.digits.cbegin(), mod.digits.cend(), m.end() - mod.digits.size());
+        m_inv = _mont_inverse(m.back() | (m[m.size() - 2] << BASE_BIN_LENGTH));
+
+        // R^2 mod m turns a number into a residue with one product
+        BigUnsigned r_squared_num(zero_digits, 2 * m.size() + 1);
+        r_squared_num.digits.front() = 1;
+        r_squared_num = r_squared_num % mod;
+        r_squared.assign(m.size(), 0);
+        std::copy(r_squared_num.digits.cbegin(), r_squared_num.digits.cend(), r_squared.end() - r_squared_num.digits.size());
+        one.assign(m.size(), 0);
+        one.back() = 1;
+        num.resize(m.size());
+        t.resize(2 * m.size() + 1);
+#if defined(BIGINT_WORDS)
+        m_64.resize(m.size() / 2);
+        scratch_64.resize(2 * m.size() + 1);
+        _pack_words(m, m_64.data(), m_64.size());
+#endif
+
+    }
+
+    const BigUnsigned& modulus() const { return modulus_; }
+
+    // digits in every residue
+    std::size_t size() const { return m.size(); }
+
+    // res = l * r / R mod m
+    void mul(LimbSpan<limb> res, LimbSpan<const limb> l, LimbSpan<const limb> r) {
+
+#if defined(BIGINT_X86_64)
+        if (cpu_level() >= CpuLevel::bmi2) {
+            _mont_mul_mulx(res, l, r, m_64.data(), m_inv, scratch_64.data());
+            return;
+        }
+#endif
+#if defined(BIGINT_WORDS)
+        if (cpu_level() >= CpuLevel::words) {
+            _mont_mul_words(res, l, r, m_64.data(), m_inv, scratch_64.data());
+            return;
+        }
+#endif
+        t.front() = 0;
+        if (l.data() == r.data()) {
+            sqr_limbs(LimbSpan<limb>(t).subspan(1), l);
+        } else {
+            mul_limbs(LimbSpan<limb>(t).subspan(1), l, r);
+        }
+        _mont_reduce_generic(res, t, m, m_inv & LIMB_MASK);
+
+    }
+
+    // res = x * x / R mod m
+    void sqr(LimbSpan<limb> res, LimbSpan<const limb> x) {
+
+        mul(res, x, x);
+
+    }
+
+    // res = l + r mod m
+    void add(LimbSpan<limb> res, LimbSpan<const limb> l, LimbSpan<const limb> r) {
+
+        if (add_limbs(res, l, r) != 0 || compare_limbs(res, m) >= 0) {
+            sub_limbs(res, res, m);
+        }
+
+    }
+
+    // res = l - r mod m
+    void sub(LimbSpan<limb> res, LimbSpan<const limb> l, LimbSpan<const limb> r) {
+
+        if (sub_limbs(res, l, r) != 0) {
+            add_limbs(res, res, m);
+        }
+
+    }
+
+    // res = x * R mod m, x is size() digits below m
+    void to_mont(LimbSpan<limb> res, LimbSpan<const limb> x) {
+
+        mul(res, x, r_squared);
+
+    }
+
+    // res = x * R mod m for any x, only allocates if x is not below m
+    void to_mont(LimbSpan<limb> res, const BigUnsigned& x) {
+
+        if (compare(x, modulus_) >= 0) {
+            to_mont(res, x % modulus_);
+            return;
+        }
+        std::fill(num.begin(), num.end() - x.digits.size(), 0);
+        std::copy(x.digits.cbegin(), x.digits.cend(), num.end() - x.digits.size());
+        mul(res, num, r_squared);
+
+    }
+
+    // res = x / R mod m, the number residue x stands for
+    void from_mont(LimbSpan<limb> res, LimbSpan<const limb> x) {
+
+        mul(res, x, one);
+
+    }
+
+    BigUnsigned from_mont(LimbSpan<const limb> x) {
+
+        BigUnsigned res(zero_digits, size());
+        from_mont(res.digits, x);
+
+        res.resize_to_fit();
+
+        return res;
+
+    }
+
+private:
+
+    BigUnsigned modulus_;
+    std::vector<limb> m; // leading zero when modulus_ has an odd number of digits
+    std::uint64_t m_inv;
+    std::vector<limb> r_squared;
+    std::vector<limb> one;
+    std::vector<limb> num;
+    std::vector<limb> t;
+#if defined(BIGINT_WORDS)
+    std::vector<std::uint64_t> m_64;
+    std::vector<std::uint64_t> scratch_64;
+#endif
+
+};
+
+// Powers
+//
+// exponents are read from the most significant bit in windows ending on a 1 bit
+// powers taken modulo a number keep every intermediate at the size of the modulus
+
+// bits per window for an exponent of bits bits, trades the odd powers made
+// up front against the multiplications saved
+inline _ui _window_bits(_ull bits) {
+
+    constexpr _ull limits[] = {8, 24, 80, 240, 672, 1792};
+    _ui window = 1;
+    while (window <= sizeof(limits) / sizeof(limits[0]) && bits > limits[window - 1]) {
+        ++window;
+    }
+    return window;
+
+}
+
+// left to right sliding window over the bits of exp, which must not be 0
+// start(i) sets the result to the odd power 2 * i + 1, then square() and multiply(i)
+// build up the rest, every window ends on a 1 bit so only odd powers are needed
+template<typename Start, typename Square, typename Multiply>
+void _sliding_window(LimbSpan<const limb> exp, const _ui window, Start start, Square square, Multiply multiply) {
+
+    bool started = false;
+    for (_ull pos = _bit_length(exp); pos != 0;) {
+        if (!_test_bit(exp, pos - 1)) {
+            square();
+            --pos;
+            continue;
+        }
+
+        _ull low = pos > window ? pos - window : 0;
+        while (!_test_bit(exp, low)) {
+            ++low;
+        }
+        std::size_t power = 0;
+        for (_ull bit = pos; bit != low; --bit) {
+            power = (power << 1) | _test_bit(exp, bit - 1);
+        }
+
+        if (started) {
+            for (_ull i = low; i != pos; ++i) {
+                square();
+            }
+            multiply(power >> 1);
+        } else {
+            start(power >> 1);
+            started = true;
+        }
+        pos = low;
+    }
+
+}
+
+// base^exp
+// every power of 2 dividing base is taken out and put back as one shift
+// throws std::overflow_error if that shift does not fit in 64 bits
+BigUnsigned pow(const BigUnsigned& base, const BigUnsigned& exp) {
+
+    if (exp.digits.empty()) {
+        return BigUnsigned(1u);
+    }
+    if (base.digits.empty() || (base.digits.size() == 1 && base.digits.front() == 1)) {
+        return base;
+    }
+
+    const _ull zeros = count_trailing_zeros(base);
+    if (zeros != 0) {
+        const _ull times = to_u64(exp);
+        if (times > std::numeric_limits<_ull>::max() / zeros) {
+            throw std::overflow_error("BigUnsigned power does not fit in 2^64 bits");
+        }
+        return pow(base >> zeros, exp) << (zeros * times);
+    }
+
+    const _ui window = _window_bits(_bit_length(exp.digits));
+    std::vector<BigUnsigned> powers(std::size_t(1) << (window - 1));
+    powers[0] = base;
+    if (window > 1) {
+        const BigUnsigned base_squared = base * base;
+        for (std::size_t i = 1; i != powers.size(); ++i) {
+            powers[i] = powers[i - 1] * base_squared;
+        }
+    }
+
+    BigUnsigned res;
+    _sliding_window(exp.digits, window,
+        [&](std::size_t i) { res = powers[i]; },
+        [&]() { res = res * res; },
+        [&](std::size_t i) { res = res * powers[i]; });
+
+    return res;
+
+}
+
+BigUnsigned pow(const BigUnsigned& base, std::uint64_t exp) {
+
+    return pow(base, BigUnsigned(exp));
+
+}
+
+// res = base^exp as a residue of mont, exp must not be 0
+void _powmod_mont(MontgomeryContext& mont, LimbSpan<limb> res, const BigUnsigned& base, const BigUnsigned& exp) {
+
+    const std::size_t n = mont.size();
+    const _ui window = _window_bits(_bit_length(exp.digits));
+    std::vector<limb> powers(n << (window - 1));
+    std::vector<limb> base_squared(n);
+    auto power = [&](std::size_t i) { return LimbSpan<limb>(powers.data() + i * n, n); };
+
+    mont.to_mont(power(0), base);
+    if (window > 1) {
+        mont.sqr(base_squared, power(0));
+        for (std::size_t i = 1; i != std::size_t(1) << (window - 1); ++i) {
+            mont.mul(power(i), power(i - 1), base_squared);
+        }
+    }
+
+    _sliding_window(exp.digits, window,
+        [&](std::size_t i) { std::copy(power(i).begin(), power(i).end(), res.begin()); },
+        [&]() { mont.sqr(res, res); },
+        [&](std::size_t i) { mont.mul(res, res, power(i)); });
+
+}
+
+// base^exp % mod with montgomery multiplication, mod must be odd
+BigUnsigned _powmod_odd(const BigUnsigned& base, const BigUnsigned& exp, const BigUnsigned& mod) {
+
+    MontgomeryContext mont(mod);
+    std::vector<limb> res(mont.size());
+    _powmod_mont(mont, res, base, exp);
+
+    return mont.from_mont(res);
+
+}
+
+// base^exp % mod with a division after every product, for even moduli
+BigUnsigned _powmod_div(const BigUnsigned& base, const BigUnsigned& exp, const BigUnsigned& mod) {
+
+    const _ui window = _window_bits(_bit_length(exp.digits));
+    std::vector<BigUnsigned> powers(std::size_t(1) << (window - 1));
+    powers[0] = base % mod;
+    const BigUnsigned base_squared = powers[0] * powers[0] % mod;
+    for (std::size_t i = 1; i != powers.size(); ++i) {
+        powers[i] = powers[i - 1] * base_squared % mod;
+    }
+
+    BigUnsigned res;
+    _sliding_window(exp.digits, window,
+        [&](std::size_t i) { res = powers[i]; },
+        [&]() { res = res * res % mod; },
+        [&](std::size_t i) { res = res * powers[i] % mod; });
+
+    return res;
+
+}
+
+// base^exp % mod
+// theta(log(exp) * mod.size^2), no intermediate is larger than twice mod
+// Note: mod must not be 0
+BigUnsigned powmod(const BigUnsigned& base, const BigUnsigned& exp, const BigUnsigned& mod) {
+
+    if (mod.digits.size() == 1 && mod.digits.front() == 1) {
+        return BigUnsigned();
+    }
+    if (exp.digits.empty()) {
+        return BigUnsigned(1u);
+    }
+    if (mod.digits.back() % 2 == 1) {
+        return _powmod_odd(base, exp, mod);
+    }
+    return _powmod_div(base, exp, mod);
+
+}
+
+// Roots
+//
+// newton's method from above, x -> ((k - 1) * x + n / x^(k - 1)) / k decreases until it reaches
+// the root and then stops decreasing
+// the first x is the root of n without its lower half of bits, found the same way and shifted
+// back, which is already right in about half the bits, so the work is a few full size
+// divisions instead of one per bit of the root
+
+// true if base^k > n
+inline bool _pow_exceeds(std::uint64_t base, _ull k, std::uint64_t n) {
+
+    std::uint64_t res = 1;
+    for (_ull i = 0; i != k && base > 1; ++i) {
+        if (res > n / base) {
+            return true;
+        }
+        res *= base;
+    }
+    return base != 0 && res > n;
+
+}
+
+// floor of the k-th root of n, k > 0
+inline std::uint64_t _root_u64(std::uint64_t n, _ull k) {
+
+    auto res = static_cast<std::uint64_t>(std::pow(static_cast<double>(n), 1.0 / static_cast<double>(k)));
+    while (res != 0 && _pow_exceeds(res, k, n)) {
+        --res;
+    }
+    while (!_pow_exceeds(res + 1, k, n)) {
+        ++res;
+    }
+    return res;
+
+}
+
+// floor of the k-th root of n, k > 1
+BigUnsigned _root(const BigUnsigned& n, _ull k) {
+
+    if (fits_u64(n)) {
+        return BigUnsigned(_root_u64(to_u64(n), k));
+    }
+    const _ull bits = bit_length(n);
+    if (k >= bits) {
+        return BigUnsigned(1u);
+    }
+
+    // root of n with the lower half of its bits gone, plus 1 to start above the root
+    // when there are too few bits for that 2^ceil(bits / k) is above the root
+    const _ull shift = bits / (2 * k);
+    BigUnsigned x(1u);
+    if (shift != 0) {
+        x = _root(n >> (shift * k), k);
+        x += 1;
+        x <<= shift;
+    } else {
+        x <<= (bits + k - 1) / k;
+    }
+
+    while (true) {
+        BigUnsigned next = (k == 2 ? n / x : n / pow(x, k - 1)) + x * (k - 1);
+        next = k < BASE ? divide_digit(next.digits.cbegin(), next.digits.cend(), k) : next / BigUnsigned(k);
+        if (next >= x) {
+            return x;
+        }
+        x = std::move(next);
+    }
+
+}
+
+// floor of the square root of num
+BigUnsigned isqrt(const BigUnsigned& num) {
+
+    return _root(num, 2);
+
+}
+
+// {floor of the square root of num, num minus its square}
+std::pair<BigUnsigned, BigUnsigned> isqrt_rem(const BigUnsigned& num) {
+
+    BigUnsigned root = isqrt(num);
+    BigUnsigned rem = num - root * root;
+    return {std::move(root), std::move(rem)};
+
+}
+
+// floor of the k-th root of num
+// throws std::domain_error if k is 0
+BigUnsigned iroot(const BigUnsigned& num, _ull k) {
+
+    if (k == 0) {
+        throw std::domain_error("BigUnsigned has no 0th root");
+    }
+    return k == 1 ? num : _root(num, k);
+
+}
+
+// num % m for m < BASE, one pass without making the quotient
+inline limb _rem_limb(LimbSpan<const limb> num, limb m) {
+
+    limb res = 0;
+    for (auto digit : num) {
+        res = ((res << BASE_BIN_LENGTH) | digit) % m;
+    }
+    return res;
+
+}
+
+// true if num is the square of an integer
+// most numbers that are not are turned away by their remainders modulo 64, 63, 65, 11, 17,
+// 19 and 23, which only some squares have, before any root is taken
+bool is_perfect_square(const BigUnsigned& num) {
+
+    static const auto squares = [] {
+        std::vector<std::vector<bool>> res(66);
+        for (_ui m = 1; m != res.size(); ++m) {
+            res[m].assign(m, false);
+            for (_ui x = 0; x != m; ++x) {
+                res[m][x * x % m] = true;
+            }
+        }
+        return res;
+    }();
+
+    if (num.digits.empty()) {
+        return true;
+    }
+    if (!squares[64][num.digits.back() % 64]) {
+        return false;
+    }
+    const limb rem = _rem_limb(num.digits, 63 * 65 * 11 * 17 * 19 * 23);
+    for (limb m : {63, 65, 11, 17, 19, 23}) {
+        if (!squares[m][rem % m]) {
+            return false;
+        }
+    }
+
+    auto root = isqrt(num);
+    return root * root == num;
+
+}
+
+// Primes
+//
+// trial division by the primes below SMALL_PRIME_LIMIT, then baillie-psw: a strong probable
+// prime test to base 2 and a strong lucas probable prime test, both on montgomery residues
+// no composite passing both is known, and there is none below 2^64
+
+constexpr _ui SMALL_PRIME_LIMIT = 1024;
+
+// primes below SMALL_PRIME_LIMIT, grouped into products of consecutive primes that fit in a digit
+struct _SmallPrimes {
+    std::vector<limb> primes;
+    std::vector<limb> groups;
+    std::vector<std::size_t> group_ends; // group i is the product of primes [group_ends[i - 1], group_ends[i])
+    BigUnsigned primorial; // product of every prime
+};
+
+inline const _SmallPrimes& _small_primes() {
+
+    static const _SmallPrimes res = [] {
+        _SmallPrimes small;
+        std::vector<bool> composite(SMALL_PRIME_LIMIT, false);
+        for (limb p = 2; p != SMALL_PRIME_LIMIT; ++p) {
+            if (!composite[p]) {
+                small.primes.push_back(p);
+                for (limb mult = p * p; mult < SMALL_PRIME_LIMIT; mult += p) {
+                    composite[mult] = true;
+                }
+            }
+        }
+
+        small.primorial = BigUnsigned(1u);
+        limb group = 1;
+        for (std::size_t i = 0; i != small.primes.size(); ++i) {
+            const limb p = small.primes[i];
+            small.primorial *= p;
+            if (group * p >= BASE) {
+                small.groups.push_back(group);
+                small.group_ends.push_back(i);
+                group = 1;
+            }
+            group *= p;
+        }
+        small.groups.push_back(group);
+        small.group_ends.push_back(small.primes.size());
+        return small;
+    }();
+    return res;
+
+}
+
+// rems[i] = num % primes[i] for every small prime
+// num above the primorial is first reduced by it with one division, then each group takes one pass
+void _small_remainders(const BigUnsigned& num, std::vector<limb>& rems) {
+
+    const auto& small = _small_primes();
+    BigUnsigned reduced;
+    LimbSpan<const limb> digits(num.digits);
+    if (num.digits.size() > small.primorial.digits.size()) {
+        reduced = num % small.primorial;
+        digits = LimbSpan<const limb>(reduced.digits);
+    }
+
+    rems.resize(small.primes.size());
+    std::size_t first = 0;
+    for (std::size_t i = 0; i != small.groups.size(); ++i) {
+        const limb group_rem = _rem_limb(digits, small.groups[i]);
+        for (; first != small.group_ends[i]; ++first) {
+            rems[first] = group_rem % small.primes[first];
+        }
+    }
+
+}
+
+// jacobi symbol (a / m), m odd
+inline int _jacobi_u64(std::uint64_t a, std::uint64_t m) {
+
+    int res = 1;
+    a %= m;
+    while (a != 0) {
+        while (a % 2 == 0) {
+            a /= 2;
+            if (m % 8 == 3 || m % 8 == 5) {
+                res = -res;
+            }
+        }
+        std::swap(a, m);
+        if (a % 4 == 3 && m % 4 == 3) {
+            res = -res;
+        }
+        a %= m;
+    }
+    return m == 1 ? res : 0;
+
+}
+
+// jacobi symbol (d / n) for n odd and |d| < BASE
+inline int _jacobi(std::int64_t d, const BigUnsigned& n) {
+
+    const limb low = n.digits.back();
+    int res = 1;
+    if (d < 0) {
+        d = -d;
+        if (low % 4 == 3) {
+            res = -res;
+        }
+    }
+    while (d % 2 == 0 && d != 0) {
+        d /= 2;
+        if (low % 8 == 3 || low % 8 == 5) {
+            res = -res;
+        }
+    }
+    // reciprocity turns it into (n % d / d), which is small
+    if (d % 4 == 3 && low % 4 == 3) {
+        res = -res;
+    }
+    return res * _jacobi_u64(_rem_limb(n.digits, static_cast<limb>(d)), static_cast<std::uint64_t>(d));
+
+}
+
+// baillie-psw on an odd n with no prime factor below SMALL_PRIME_LIMIT, plus rounds more
+// strong probable prime tests to the odd primes 3, 5, 7, ... below SMALL_PRIME_LIMIT
+// composite bases are weaker and base 4 repeats base 2, so they are skipped
+bool _probable_prime(const BigUnsigned& n, _ui rounds) {
+
+    MontgomeryContext mont(n);
+    const std::size_t size = mont.size();
+    auto residue = [&mont, size](std::int64_t value) {
+        std::vector<limb> res(size);
+        mont.to_mont(res, BigUnsigned(static_cast<_ull>(value < 0 ? -value : value)));
+        if (value < 0) {
+            mont.sub(res, std::vector<limb>(size, 0), res);
+        }
+        return res;
+    };
+    const std::vector<limb> zero(size, 0);
+    const std::vector<limb> one = residue(1);
+    const std::vector<limb> minus_one = residue(-1);
+    std::vector<limb> x(size);
+
+    // n - 1 = d * 2^s with d odd, base^d is 1 or one of the next s - 1 squarings is -1 for a prime
+    const BigUnsigned n_minus_1 = n - 1;
+    const _ull s = count_trailing_zeros(n_minus_1);
+    const BigUnsigned d = n_minus_1 >> s;
+    auto strong_probable_prime = [&](_ull base) {
+        _powmod_mont(mont, x, BigUnsigned(base), d);
+        if (x == one || x == minus_one) {
+            return true;
+        }
+        for (_ull i = 1; i < s; ++i) {
+            mont.sqr(x, x);
+            if (x == minus_one) {
+                return true;
+            }
+            if (x == one) {
+                return false;
+            }
+        }
+        return false;
+    };
+    if (!strong_probable_prime(2)) {
+        return false;
+    }
+
+    // lucas sequences with p = 1 and q = (1 - d) / 4, the first d of 5, -7, 9, -11, ... with
+    // (d / n) = -1, which only fails to exist for squares
+    if (is_perfect_square(n)) {
+        return false;
+    }
+    std::int64_t disc = 5;
+    for (int jacobi = _jacobi(disc, n); jacobi != -1; jacobi = _jacobi(disc, n)) {
+        if (jacobi == 0) {
+            return false; // |disc| is a factor, n is larger than it
+        }
+        disc = disc > 0 ? -(disc + 2) : -disc + 2;
+    }
+    const std::vector<limb> disc_res = residue(disc);
+    const std::vector<limb> q_res = residue((1 - disc) / 4);
+
+    // u and v at k = n + 1 without its factors of 2, from the top bit down
+    // u_2k = u_k * v_k, v_2k = v_k^2 - 2 * q^k
+    // u_k+1 = (u_k + v_k) / 2, v_k+1 = (disc * u_k + v_k) / 2
+    std::vector<limb> u = one;
+    std::vector<limb> v = one;
+    std::vector<limb> q_k = q_res;
+    std::vector<limb> t(size);
+    auto half = [&mont](std::vector<limb>& num) {
+        limb carry = 0;
+        if (num.back() % 2 == 1) {
+            carry = add_limbs(num, num, mont.modulus().digits);
+        }
+        shr_limbs(num, num, 1);
+        num.front() |= carry << (BASE_BIN_LENGTH - 1);
+    };
+    auto v_double = [&]() {
+        mont.sqr(v, v);
+        mont.sub(v, v, q_k);
+        mont.sub(v, v, q_k);
+        mont.sqr(q_k, q_k);
+    };
+    const BigUnsigned n_plus_1 = n + 1;
+    const _ull lucas_s = count_trailing_zeros(n_plus_1);
+    const BigUnsigned lucas_d = n_plus_1 >> lucas_s;
+    for (_ull bit = bit_length(lucas_d) - 1; bit != 0; --bit) {
+        mont.mul(u, u, v);
+        v_double();
+        if (test_bit(lucas_d, bit - 1)) {
+            mont.mul(t, disc_res, u);
+            mont.add(u, u, v);
+            half(u);
+            mont.add(v, t, v);
+            half(v);
+            mont.mul(q_k, q_k, q_res);
+        }
+    }
+    bool lucas = u == zero || v == zero;
+    for (_ull i = 1; !lucas && i < lucas_s; ++i) {
+        v_double();
+        lucas = v == zero;
+    }
+    if (!lucas) {
+        return false;
+    }
+
+    const auto& primes = _small_primes().primes;
+    for (std::size_t i = 1; i <= rounds && i != primes.size(); ++i) {
+        if (!strong_probable_prime(primes[i])) {
+            return false;
+        }
+    }
+    return true;
+
+}
+
+// true if num is prime, and for a composite num false except with a vanishing chance
+// baillie-psw, exact for num below 2^64, rounds adds strong probable prime tests to the next
+// odd prime bases, at most the 171 below SMALL_PRIME_LIMIT are used
+bool is_probable_prime(const BigUnsigned& num, _ui rounds = 0) {
+
+    const auto& small = _small_primes();
+    if (num.digits.size() == 1 && num.digits.front() < SMALL_PRIME_LIMIT) {
+        return std::binary_search(small.primes.cbegin(), small.primes.cend(), num.digits.front());
+    }
+    if (num.digits.empty() || num.digits.back() % 2 == 0) {
+        return false;
+    }
+
+    std::vector<limb> rems;
+    _small_remainders(num, rems);
+    if (std::find(rems.cbegin(), rems.cend(), 0) != rems.cend()) {
+        return false;
+    }
+    if (num.digits.size() == 1 && num.digits.front() < SMALL_PRIME_LIMIT * SMALL_PRIME_LIMIT) {
+        return true;
+    }
+    return _probable_prime(num, rounds);
+
+}
+
+// smallest prime larger than num
+// windows of odd numbers are sieved by the small primes and only what is left is tested
+BigUnsigned next_prime(const BigUnsigned& num) {
+
+    const auto& small = _small_primes();
+    if (num.digits.size() <= 1) {
+        limb low = num.digits.empty() ? 0 : num.digits.front();
+        auto iter = std::upper_bound(small.primes.cbegin(), small.primes.cend(), low);
+        if (iter != small.primes.cend()) {
+            return BigUnsigned(*iter);
+        }
+    }
+
+    // start + 2 * i for i in [0, window), start is odd and larger than every small prime
+    BigUnsigned start = num + 1;
+    if (start.digits.back() % 2 == 0) {
+        start += 1;
+    }
+    const std::size_t window = 2 * static_cast<std::size_t>(bit_length(start)) + 64;
+    std::vector<bool> composite(window);
+    std::vector<limb> rems;
+    while (true) {
+        std::fill(composite.begin(), composite.end(), false);
+        _small_remainders(start, rems);
+        for (std::size_t i = 1; i != small.primes.size(); ++i) {
+            // start + 2 * j = 0 mod p at j = -rem / 2 mod p
+            const limb p = small.primes[i];
+            for (limb j = (p - rems[i]) % p * ((p + 1) / 2) % p; j < window; j += p) {
+                composite[j] = true;
+            }
+        }
+        for (std::size_t i = 0; i != window; ++i) {
+            if (!composite[i]) {
+                BigUnsigned candidate = start + 2 * i;
+                if (_probable_prime(candidate, 0)) {
+                    return candidate;
+                }
+            }
+        }
+        start += 2 * window;
+    }
+
+}
+
+// Products and sums
+//
+// a product of many numbers is built as a tree split where both sides have about the same
+// digits, so the large multiplications are between numbers of about the same size
+// a sum adds every number into words that are not carried, since digits only use the lower
+// half of each word, and carries once at the end
+// the parallel versions hand independent halves of the tree, or parts of the range, to the
+// thread pool
+
+// tags choosing how a batch operation runs
+struct sequential_t {};
+struct parallel_t {};
+constexpr sequential_t sequential{};
+constexpr parallel_t parallel{};
+
+constexpr std::size_t PARALLEL_MIN_DIGITS = 4096; // work on fewer digits stays on one thread
+
+// carry words holding more than a digit into the word before them, the first word must not overflow
+inline void _carry_words(std::vector<_ull>& words) {
+
+    for (std::size_t i = words.size() - 1; i != 0; --i) {
+        words[i - 1] += words[i] >> BASE_BIN_LENGTH;
+        words[i] &= LIMB_MASK;
+    }
+
+}
+
+// product of nums [first, last), ends[i] is the number of digits in nums [0, i]
+BigUnsigned _product_tree(const std::vector<const BigUnsigned*>& nums, const std::vector<std::size_t>& ends,
+                          std::size_t first, std::size_t last, _ui threads) {
+
+    if (last - first == 1) {
+        return *nums[first];
+    }
+    if (last - first == 2) {
+        return *nums[first] * *nums[first + 1];
+    }
+
+    const std::size_t before = first == 0 ? 0 : ends[first - 1];
+    const std::size_t half = before + (ends[last - 1] - before) / 2;
+    std::size_t mid = static_cast<std::size_t>(std::upper_bound(ends.cbegin() + first, ends.cbegin() + last, half) - ends.cbegin()) + 1;
+    mid = std::min(std::max(mid, first + 1), last - 1);
+
+    if (threads > 1 && ends[last - 1] - before >= PARALLEL_MIN_DIGITS) {
+        BigUnsigned halves[2];
+        _parallel_pool().run(2, [&](std::size_t i) {
+            halves[i] = i == 0 ? _product_tree(nums, ends, first, mid, threads / 2) : _product_tree(nums, ends, mid, last, threads - threads / 2);
+        });
+        return halves[0] * halves[1];
+    }
+    return _product_tree(nums, ends, first, mid, 1) * _product_tree(nums, ends, mid, last, 1);
+
+}
+
+template<typename Forward>
+BigUnsigned _product(Forward first, Forward last, _ui threads) {
+
+    std::vector<const BigUnsigned*> nums;
+    std::vector<std::size_t> ends;
+    for (; first != last; ++first) {
+        if (first->digits.empty()) {
+            return BigUnsigned();
+        }
+        nums.push_back(&*first);
+        ends.push_back((ends.empty() ? 0 : ends.back()) + first->digits.size());
+    }
+    if (nums.empty()) {
+        return BigUnsigned(1u);
+    }
+    return _product_tree(nums, ends, 0, nums.size(), threads);
+
+}
+
+// add nums [first, last) into acc without carrying, every number is aligned on the last word
+// acc must be longer than every number, one pass carries after each LIMB_MASK additions
+void _accumulate(std::vector<_ull>& acc, const BigUnsigned* const* first, const BigUnsigned* const* last) {
+
+    _ull added = 0;
+    for (; first != last; ++first) {
+        if (added == LIMB_MASK) {
+            _carry_words(acc);
+            added = 0;
+        }
+        const auto& digits = (*first)->digits;
+        _ull* out = acc.data() + (acc.size() - digits.size());
+        for (std::size_t i = 0; i != digits.size(); ++i) {
+            out[i] += digits[i];
+        }
+        ++added;
+    }
+    _carry_words(acc);
+
+}
+
+template<typename Forward>
+BigUnsigned _sum(Forward first, Forward last, _ui threads) {
+
+    std::vector<const BigUnsigned*> nums;
+    std::size_t longest = 0;
+    std::size_t total = 0;
+    for (; first != last; ++first) {
+        nums.push_back(&*first);
+        longest = std::max(longest, first->digits.size());
+        total += first->digits.size();
+    }
+
+    // up to 2^64 numbers below BASE^longest add to less than BASE^(longest + 2)
+    BigUnsigned res(zero_digits, longest + 2);
+    threads = static_cast<_ui>(std::min<std::size_t>({threads, nums.size(), total / PARALLEL_MIN_DIGITS + 1}));
+    if (threads <= 1) {
+        _accumulate(res.digits, nums.data(), nums.data() + nums.size());
+    } else {
+        // every thread sums a part with its own words, then the parts are summed
+        std::vector<std::vector<_ull>> parts(threads, std::vector<_ull>(res.digits.size(), 0));
+        _parallel_pool().run(threads, [&](std::size_t i) {
+            _accumulate(parts[i], nums.data() + nums.size() * i / threads, nums.data() + nums.size() * (i + 1) / threads);
+        });
+        for (const auto& part : parts) {
+            for (std::size_t i = 0; i != part.size(); ++i) {
+                res.digits[i] += part[i];
+            }
+        }
+        _carry_words(res.digits);
+    }
+
+    res.resize_to_fit();
+    return res;
+
+}
+
+// product of every number in [first, last), 1 for an empty range
+// Forward must be multipass with value_type BigUnsigned
+template<typename Forward>
+BigUnsigned product(sequential_t, Forward first, Forward last) {
+
+    return _product(first, last, 1);
+
+}
+
+template<typename Forward>
+BigUnsigned product(parallel_t, Forward first, Forward last) {
+
+    return _product(first, last, parallel_threads());
+
+}
+
+template<typename Forward>
+BigUnsigned product(Forward first, Forward last) {
+
+    return _product(first, last, 1);
+
+}
+
+// sum of every number in [first, last), 0 for an empty range
+// Forward must be multipass with value_type BigUnsigned
+template<typename Forward>
+BigUnsigned sum(sequential_t, Forward first, Forward last) {
+
+    return _sum(first, last, 1);
+
+}
+
+template<typename Forward>
+BigUnsigned sum(parallel_t, Forward first, Forward last) {
+
+    return _sum(first, last, parallel_threads());
+
+}
+
+template<typename Forward>
+BigUnsigned sum(Forward first, Forward last) {
+
+    return _sum(first, last, 1);
+
+}
+
+// Factorials
+//
+// products of many small factors are packed into digits and multiplied as a balanced tree,
+// so the large multiplications are between numbers of about the same size
+// factorials use luschny's prime swing, n! = (n / 2)!^2 * swing(n) where swing(n) is a
+// product of prime powers found without division of large numbers
+
+// product of factors, consecutive ones are packed into a digit before the tree is built
+BigUnsigned _product_factors(const std::vector<_ull>& factors) {
+
+    std::vector<BigUnsigned> nums;
+    limb packed = 1;
+    for (auto factor : factors) {
+        if (factor == 0) {
+            return BigUnsigned();
+        }
+        if (factor > LIMB_MASK) {
+            nums.emplace_back(factor);
+        } else if (packed * factor > LIMB_MASK) {
+            nums.emplace_back(packed);
+            packed = factor;
+        } else {
+            packed *= factor;
+        }
+    }
+    if (packed != 1 || nums.empty()) {
+        nums.emplace_back(packed);
+    }
+    return product(nums.cbegin(), nums.cend());
+
+}
+
+// every prime up to n, n must fit in a digit
+std::vector<_ull> _primes_to(_ull n) {
+
+    std::vector<_ull> res;
+    if (n < 2) {
+        return res;
+    }
+    res.push_back(2);
+
+    // composite[i] for the odd number 2 * i + 1
+    std::vector<bool> composite(n / 2 + 1, false);
+    for (_ull i = 1; 2 * i + 1 <= n; ++i) {
+        if (!composite[i]) {
+            const _ull p = 2 * i + 1;
+            res.push_back(p);
+            for (_ull mult = p * p; mult <= n; mult += 2 * p) {
+                composite[mult / 2] = true;
+            }
+        }
+    }
+    return res;
+
+}
+
+inline void _check_factorial_arg(_ull n) {
+
+    if (n > LIMB_MASK) {
+        throw std::overflow_error("BigUnsigned factorial argument does not fit in a digit");
+    }
+
+}
+
+// odd part of n!, from the odd primes in primes
+BigUnsigned _odd_factorial(_ull n, const std::vector<_ull>& primes) {
+
+    if (n <= 20) {
+        _ull res = 1;
+        for (_ull i = 2; i <= n; ++i) {
+            res *= i;
+        }
+        return BigUnsigned(res >> _trailing_zeros(res));
+    }
+
+    // odd prime p appears in swing(n) once per odd n / p^k
+    std::vector<_ull> factors;
+    for (auto iter = primes.cbegin() + 1; iter != primes.cend() && *iter <= n; ++iter) {
+        for (_ull q = n / *iter; q != 0; q /= *iter) {
+            if (q % 2 == 1) {
+                factors.push_back(*iter);
+            }
+        }
+    }
+    BigUnsigned half = _odd_factorial(n / 2, primes);
+    return half * half * _product_factors(factors);
+
+}
+
+// n! = 1 * 2 * ... * n
+// throws std::overflow_error if n does not fit in a digit
+BigUnsigned factorial(_ull n) {
+
+    _check_factorial_arg(n);
+    // n! has n - popcount(n) factors of 2
+    return _odd_factorial(n, _primes_to(n)) << (n - _popcount(n));
+
+}
+
+// number of ways to choose k of n, 0 if k > n
+// for k near n or 0 it is n (n - 1) ... (n - k + 1) / k!, otherwise the product of the primes
+// up to n, each to the power of the carries made when adding k and n - k in its base
+// throws std::overflow_error if k! is needed and k does not fit in a digit
+BigUnsigned binomial(_ull n, _ull k) {
+
+    if (k > n) {
+        return BigUnsigned();
+    }
+    k = std::min(k, n - k);
+    std::vector<_ull> factors;
+    if (n > LIMB_MASK || k < n / 64) {
+        for (_ull i = n - k + 1; i <= n && i != 0; ++i) {
+            factors.push_back(i);
+        }
+        return _product_factors(factors) / factorial(k);
+    }
+
+    for (auto p : _primes_to(n)) {
+        // legendre, the exponent is sum over i of n / p^i - k / p^i - (n - k) / p^i
+        for (_ull n_q = n / p, k_q = k / p, rest_q = (n - k) / p; n_q != 0; n_q /= p, k_q /= p, rest_q /= p) {
+            for (_ull times = n_q - k_q - rest_q; times != 0; --times) {
+                factors.push_back(p);
+            }
+        }
+    }
+    return _product_factors(factors);
+
+}
+
+// product of every prime up to n
+// throws std::overflow_error if n does not fit in a digit
+BigUnsigned primorial(_ull n) {
+
+    _check_factorial_arg(n);
+    return _product_factors(_primes_to(n));
+
+}
+
+// Fibonacci numbers
+//
+// fast doubling from the top bit of n down, each step takes F(k) and F(k - 1) to F(2k) and
+// F(2k - 1), or F(2k + 1) and F(2k), with two squares, F(k)^2 and F(k - 1)^2
+// F(2k + 1) = 4 F(k)^2 - F(k - 1)^2 + 2 (-1)^k
+// F(2k - 1) = F(k)^2 + F(k - 1)^2
+// F(2k) = F(2k + 1) - F(2k - 1)
+
+// F(n) and F(n - 1) for n > 0
+std::pair<BigUnsigned, BigUnsigned> _fibonacci_pair(_ull n) {
+
+    // the top bits of n, up to F(93) which is the largest in 64 bits, are found natively
+    _ui shift = 0;
+    while ((n >> shift) > 93) {
+        ++shift;
+    }
+    _ull k = n >> shift;
+    std::uint64_t f_k = 1;
+    std::uint64_t f_prev = 0;
+    for (_ull i = 1; i != k; ++i) {
+        f_k += f_prev;
+        f_prev = f_k - f_prev;
+    }
+
+    BigUnsigned f(f_k);
+    BigUnsigned f_1(f_prev);
+    for (; shift != 0; --shift) {
+        BigUnsigned f_sqr = f * f;
+        BigUnsigned f_1_sqr = f_1 * f_1;
+        BigUnsigned f_next = (f_sqr << 2) - f_1_sqr;
+        if (k % 2 == 0) {
+            f_next += 2;
+        } else {
+            f_next -= 2;
+        }
+        BigUnsigned f_prev_2 = f_sqr + f_1_sqr; // F(2k - 1)
+        BigUnsigned f_2 = f_next - f_prev_2;
+        k = (n >> (shift - 1));
+        if (k % 2 == 1) {
+            f = std::move(f_next);
+            f_1 = std::move(f_2);
+        } else {
+            f = std::move(f_2);
+            f_1 = std::move(f_prev_2);
+        }
+    }
+    return {std::move(f), std::move(f_1)};
+
+}
+
+// F(n), with F(0) = 0 and F(1) = 1
+BigUnsigned fibonacci(_ull n) {
+
+    if (n == 0) {
+        return BigUnsigned();
+    }
+    return _fibonacci_pair(n).first;
+
+}
+
+// L(n), with L(0) = 2 and L(1) = 1
+// L(n) = F(n) + 2 F(n - 1)
+BigUnsigned lucas(_ull n) {
+
+    if (n == 0) {
+        return BigUnsigned(2u);
+    }
+    auto pair = _fibonacci_pair(n);
+    return pair.first + (pair.second << 1);
+
+}
+
+// Base 10 conversion
+//
+// base 10 digits are grouped into chunks of BASE_DIGITS_ALLOW digits, a chunk always fits in one digit
+// both directions split the number in halves around 10^(BASE_DIGITS_ALLOW * 2^k) which are cached
+// the halves are independent, so large ones are converted on the thread pool once
+// set_parallel_convert_digits is called, printed halves go to disjoint parts of the string
+
+constexpr _ull _pow_10(_ui exp) {
+
+    _ull res = 1;
+    for (_ui i = 0; i != exp; ++i) {
+        res *= 10;
+    }
+    return res;
+
+}
+
+constexpr _ull DEC_CHUNK = _pow_10(BASE_DIGITS_ALLOW); // 10^BASE_DIGITS_ALLOW < BASE
+constexpr BigUnsigned::sz_ty_ull DEC_SPLIT_CHUNKS = 32; // below this many chunks parse digit by digit
+constexpr BigUnsigned::sz_ty_ull DEC_SPLIT_LIMBS = 32; // below this many digits print chunk by chunk
+
+// process wide cache of 10^(BASE_DIGITS_ALLOW * 2^k), entry k + 1 is entry k squared
+// grows when a conversion needs a larger power, safe to use from multiple threads
+// entries are shared so clearing the cache never invalidates a conversion in progress
+// powers are squared without holding the lock, the square may run on the thread pool
+class Pow10Cache {
+public:
+
+    using power_ptr = std::shared_ptr<const BigUnsigned>;
+
+    static Pow10Cache& instance() {
+
+        static Pow10Cache cache;
+        return cache;
+
+    }
+
+    // 10^(BASE_DIGITS_ALLOW * 2^k)
+    // powers past the memory limit are computed every time and not stored
+    power_ptr get(std::size_t k) {
+
+        std::unique_lock<std::mutex> guard(lock);
+
+        while (powers.size() <= k) {
+            const power_ptr last = powers.back();
+            const std::size_t index = powers.size();
+            guard.unlock();
+            auto next = std::make_shared<const BigUnsigned>(*last * *last);
+            guard.lock();
+            if (powers.size() != index) {
+                continue; // another thread added or cleared entries meanwhile
+            }
+
+            auto next_bytes = next->digits.size() * sizeof(_ull);
+            if (bytes + next_bytes > max_bytes) {
+                guard.unlock();
+                for (auto i = index; i != k; ++i) {
+                    next = std::make_shared<const BigUnsigned>(*next * *next);
+                }
+                return next;
+            }
+            bytes += next_bytes;
+            powers.push_back(std::move(next));
+        }
+
+        return powers[k];
+
+    }
+
+    // compute every power needed to convert numbers of up to max_digits base 10 digits
+    void reserve(std::size_t max_digits) {
+
+        std::size_t k = 0;
+        for (std::size_t digits = BASE_DIGITS_ALLOW; digits < max_digits; digits *= 2) {
+            ++k;
+        }
+        get(k);
+
+    }
+
+    // stored powers never take more than max bytes, larger ones are dropped
+    void limit(std::size_t max) {
+
+        std::lock_guard<std::mutex> guard(lock);
+
+        max_bytes = max;
+        while (powers.size() > 1 && bytes > max_bytes) {
+            bytes -= powers.back()->digits.size() * sizeof(_ull);
+            powers.pop_back();
+        }
+
+    }
+
+    void clear() {
+
+        std::lock_guard<std::mutex> guard(lock);
+
+        powers.resize(1);
+        bytes = 0;
+
+    }
+
+    std::size_t memory() {
+
+        std::lock_guard<std::mutex> guard(lock);
+
+        return bytes;
+
+    }
+
+private:
+
+    Pow10Cache() : bytes(0), max_bytes(std::numeric_limits<std::size_t>::max()) {
+
+        powers.push_back(std::make_shared<const BigUnsigned>(DEC_CHUNK)); // a single digit, not counted against the limit
+
+    }
+
+    std::mutex lock;
+    std::vector<power_ptr> powers;
+    std::size_t bytes;
+    std::size_t max_bytes;
+
+};
+
+// call at startup to precompute the powers for numbers up to max_digits base 10 digits
+void pow10_cache_reserve(std::size_t max_digits) {
+
+    Pow10Cache::instance().reserve(max_digits);
+
+}
+
+// cap the memory used by cached powers, default is no cap
+void pow10_cache_limit(std::size_t max_bytes) {
+
+    Pow10Cache::instance().limit(max_bytes);
+
+}
+
+void pow10_cache_clear() {
+
+    Pow10Cache::instance().clear();
+
+}
+
+std::size_t pow10_cache_bytes() {
+
+    return Pow10Cache::instance().memory();
+
+}
+
+// base 10 conversions of numbers with at least digits digits of BASE, the unit of
+// BigUnsigned::digits, convert their halves on the thread pool, 0 turns it off
+// parsing counts the digits of BASE the value will take
+// not thread safe, only call while no other thread is using the library
+void set_parallel_convert_digits(std::size_t digits) {
+
+    _parallel_state().convert_digits = digits;
+
+}
+
+std::size_t parallel_convert_digits() {
+
+    return _parallel_state().convert_digits;
+
+}
+
+// true if a conversion of a number with size digits of BASE should split its halves between threads
+inline bool _parallel_convert(std::size_t size) {
+
+    const std::size_t digits = parallel_convert_digits();
+    return digits != 0 && size >= digits && parallel_threads() > 1;
+
+}
+
+// value of count chunks, most significant first
+BigUnsigned::cont_ull _chunks_to_digits(const _ull* const chunks, std::size_t count) {
+
+    if (count <= DEC_SPLIT_CHUNKS) {
+        BigUnsigned::cont_ull res(count, 0); // 10^(BASE_DIGITS_ALLOW * count) < BASE^count
+        auto res_first = res.data() + res.size(); // digits before this are still 0
+        for (std::size_t i = 0; i != count; ++i) {
+            LimbSpan<limb> used(res_first, static_cast<std::size_t>(res.data() + res.size() - res_first));
+            limb carry = mul_limb(used, used, DEC_CHUNK, chunks[i]);
+            if (carry != 0) {
+                *--res_first = carry;
+            }
+        }
+        return res;
+    }
+
+    std::size_t k = 0;
+    while ((std::size_t(2) << k) < count) {
+        ++k;
+    }
+    const std::size_t low_count = std::size_t(1) << k;
+
+    auto power = Pow10Cache::instance().get(k);
+    BigUnsigned::cont_ull high;
+    BigUnsigned::cont_ull low;
+    auto convert = [&](std::size_t i) {
+        if (i == 0) {
+            high = _chunks_to_digits(chunks, count - low_count);
+        } else {
+            low = _chunks_to_digits(chunks + (count - low_count), low_count);
+        }
+    };
+    // 10^BASE_DIGITS_ALLOW is about 2^29.9, so count chunks take about 0.93 count digits of BASE
+    if (_parallel_convert(count * BASE_DIGITS_ALLOW * 3322 / (1000 * BASE_BIN_LENGTH) + 1)) {
+        _parallel_pool().run(2, convert);
+    } else {
+        convert(0);
+        convert(1);
+    }
+
+    auto high_span = _strip_zeros(high);
+    BigUnsigned::cont_ull res(high_span.size() + power->digits.size());
+    mul_limbs(res, high_span, power->digits);
+    add_limbs(res, res, _strip_zeros(low)); // high * power + low < (high + 1) * power, no carry
+
+    return res;
+
+}
+
+// convert from base 10 to desired base
+void BigUnsigned::_create(cont_ui::iterator digit_local_iter, sz_ty_ui size_local) {
+
+    cont_ull chunks((size_local + BASE_DIGITS_ALLOW - 1) / BASE_DIGITS_ALLOW);
+    auto chunk_len = size_local - ((chunks.size() - 1) * BASE_DIGITS_ALLOW); // first chunk may be shorter
+    for (auto iter = chunks.begin(); iter != chunks.end(); ++iter) {
+        *iter = _unchecked_to_num(digit_local_iter, digit_local_iter + chunk_len);
+        digit_local_iter += chunk_len;
+        chunk_len = BASE_DIGITS_ALLOW;
+    }
+
+    digits = _chunks_to_digits(chunks.data(), chunks.size());
+
+    resize_to_fit();
+
+}
+
+// write num into [first, last) in base 10, right aligned and padded with '0'
+// requires num < 10^(last - first)
+void _digits_to_chars(LimbSpan<const limb> num, char* const first, char* last) {
+
+    num = _strip_zeros(num);
+
+    if (num.size() <= DEC_SPLIT_LIMBS) {
+        BigUnsigned::cont_ull rem(num.begin(), num.end());
+        LimbSpan<limb> rem_span(rem);
+        while (!rem_span.empty()) {
+            limb chunk = divmod_limb(rem_span, rem_span, DEC_CHUNK);
+            if (rem_span.front() == 0) {
+                rem_span = rem_span.subspan(1);
+            }
+            for (_ui i = 0; i != BASE_DIGITS_ALLOW && last != first; ++i, chunk /= 10) {
+                *--last = static_cast<char>('0' + (chunk % 10));
+            }
+        }
+        return;
+    }
+
+    // split with the power closest to half the size of num
+    auto& cache = Pow10Cache::instance();
+    std::size_t k = 0;
+    while (cache.get(k + 1)->digits.size() * 2 <= num.size()) {
+        ++k;
+    }
+    auto power = cache.get(k);
+
+    BigUnsigned::cont_ull q(num.size() - power->digits.size() + 1);
+    BigUnsigned::cont_ull r(power->digits.size());
+    divmod_limbs(q, r, num, power->digits);
+
+    char* const middle = last - (static_cast<std::size_t>(BASE_DIGITS_ALLOW) << k);
+    auto convert = [&](std::size_t i) {
+        if (i == 0) {
+            _digits_to_chars(r, middle, last);
+        } else {
+            _digits_to_chars(q, first, middle);
+        }
+    };
+    if (_parallel_convert(num.size())) {
+        _parallel_pool().run(2, convert);
+    } else {
+        convert(0);
+        convert(1);
+    }
+
+}
+
+// base 10 string of num
+std::string to_string(const BigUnsigned& num) {
+
+    if (num.digits.empty()) {
+        return "0";
+    }
+
+    // every digit of BASE takes at most BASE_DIGITS base 10 digits
+    std::string res(num.digits.size() * BASE_DIGITS, '0');
+    _digits_to_chars(num.digits, &res[0], &res[0] + res.size());
+
+    res.erase(0, res.find_first_not_of('0'));
+
+    return res;
+
+}
+
+// return base 10 container representation of a bigunsigned
+// with most signficant digits in the container being lower index
+// 0 is an empty container
+BigUnsigned::cont_ull BigUnsigned_10(const BigUnsigned& num) {
+
+    BigUnsigned::cont_ull res;
+    if (num.digits.empty()) {
+        return res;
+    }
+
+    auto str = to_string(num);
+    res.reserve(str.size());
+    std::for_each(str.cbegin(), str.cend(), [&res](auto c) {
+        res.push_back(static_cast<_ull>(c - '0'));
+    });
+
+    return res;
+
+}
+
+// Floating point conversion
+
+// correctly rounded (to nearest, ties to even) num as Floating, infinity if too large
+// only reads the digits holding the leading numeric_limits<Floating>::digits + 1 bits
+// except for exact ties which look further until a non zero digit
+template<typename Floating>
+Floating _to_floating(LimbSpan<const limb> num) {
+
+    num = _strip_zeros(num);
+    const _ull bits = _bit_length(num);
+    const _ull mant = static_cast<_ull>(std::numeric_limits<Floating>::digits);
+    const _ull low = bits > mant ? bits - mant : 0; // lowest bit kept
+
+    // num >> low, at most mant bits so every step is exact
+    Floating res = 0;
+    const auto low_index = low / BASE_BIN_LENGTH;
+    for (decltype(num.size()) i = 0; i != num.size() - low_index; ++i) {
+        auto index = num.size() - 1 - i; // digit i is worth BASE^index
+        limb digit = num[i];
+        _ull pos = index * BASE_BIN_LENGTH;
+        if (index == low_index) {
+            digit >>= low % BASE_BIN_LENGTH;
+            pos = low;
+        }
+        res += std::ldexp(static_cast<Floating>(digit), static_cast<int>(pos - low));
+    }
+
+    if (low != 0 && _test_bit(num, low - 1)) { // at least half way to the next value
+        bool round_up = _test_bit(num, low); // odd rounds up on a tie
+        for (_ull pos = low - 1; !round_up && pos % BASE_BIN_LENGTH != 0; ) {
+            round_up = _test_bit(num, --pos);
+        }
+        for (auto index = (low - 1) / BASE_BIN_LENGTH; !round_up && index != 0; ) {
+            round_up = num[num.size() - index--] != 0;
+        }
+        if (round_up) {
+            res += 1; // at most 2^mant, still exact
+        }
+    }
+
+    if (low > static_cast<_ull>(std::numeric_limits<Floating>::max_exponent)) {
+        return std::numeric_limits<Floating>::infinity();
+    }
+    return std::ldexp(res, static_cast<int>(low));
+
+}
+
+double to_double(const BigUnsigned& num) {
+
+    return _to_floating<double>(num.digits);
+
+}
+
+long double to_long_double(const BigUnsigned& num) {
+
+    return _to_floating<long double>(num.digits);
+
+}
+
+// exact integer part of value, 0 for negative, infinite and NaN values
+template<typename Floating, typename>
+BigUnsigned::BigUnsigned(Floating value) : digits() {
+
+    if (!(value >= 1) || std::isinf(value)) {
+        return;
+    }
+
+    int exp;
+    std::frexp(value, &exp); // value = f * 2^exp with f in [0.5, 1)
+    const int mant = std::numeric_limits<Floating>::digits;
+    const int shift = exp > mant ? exp - mant : 0;
+
+    // integer part is whole * 2^shift where whole has at most mant bits
+    Floating whole = std::trunc(std::ldexp(value, -shift));
+    while (whole != 0) {
+        Floating digit = std::fmod(whole, static_cast<Floating>(BASE));
+        digits.insert(digits.cbegin(), static_cast<_ull>(digit));
+        whole = (whole - digit) / static_cast<Floating>(BASE);
+    }
+
+    *this <<= static_cast<_ull>(shift);
+
+}
+
+// return base 10 double representation of a bigunsigned
+// correctly rounded, infinity when too large for double
+double BigUnsigned_10_dbl(const BigUnsigned& num) {
+
+    return to_double(num);
+
+}
+
+
+// Signed numbers
+//
+// sign and magnitude, zero is never negative
+// division truncates toward zero and the remainder takes the sign of the dividend, same as int
+
+class BigInt {
+public:
+
+    explicit BigInt() : magnitude(), negative(false) {}
+
+    explicit BigInt(BigUnsigned mag, bool neg = false) : magnitude(std::move(mag)), negative(neg) {
+
+        fix_sign();
+
+    }
+
+    // base 10 with an optional leading '-' or '+'
+    explicit BigInt(const std::string& s) : magnitude(), negative(false) {
+
+        bool sign = !s.empty() && (s.front() == '-' || s.front() == '+');
+        magnitude = BigUnsigned(s.substr(sign ? 1 : 0));
+        negative = sign && s.front() == '-';
+        fix_sign();
+
+    }
+
+    template<typename Integral, std::enable_if_t<std::is_integral_v<Integral> && !std::is_same_v<Integral, bool> &&
+                                                 std::numeric_limits<Integral>::digits <= std::numeric_limits<_ull>::digits, int> = 0>
+    explicit BigInt(Integral value) : magnitude(), negative(value < 0) {
+
+        _ull mag = static_cast<_ull>(value);
+        if (value < 0) {
+            mag = 0 - mag; // fine for the lowest value, which has no positive counterpart
+        }
+        magnitude = BigUnsigned(mag);
+
+    }
+
+    // true if zero
+    bool is_zero() const { return magnitude.digits.empty(); }
+
+    // -1, 0 or 1
+    int sign() const { return negative ? -1 : (is_zero() ? 0 : 1); }
+
+    // call after changing magnitude directly
+    void fix_sign() {
+
+        if (magnitude.digits.empty()) {
+            negative = false;
+        }
+
+    }
+
+    BigUnsigned magnitude;
+    bool negative;
+
+};
+
+BigInt abs(BigInt num) {
+
+    num.negative = false;
+    return num;
+
+}
+
+BigInt operator- (BigInt num) {
+
+    num.negative = !num.negative;
+    num.fix_sign();
+    return num;
+
+}
+
+BigInt operator+ (BigInt num) {
+
+    return num;
+
+}
+
+// negative if l < r, 0 if l == r, positive if l > r
+int compare(const BigInt& l, const BigInt& r) {
+
+    if (l.negative != r.negative) {
+        return l.negative ? -1 : 1;
+    }
+    int cmp = compare(l.magnitude, r.magnitude);
+    return l.negative ? -cmp : cmp;
+
+}
+
+#if defined(__cpp_lib_three_way_comparison)
+std::strong_ordering operator<=> (const BigInt& l, const BigInt& r) {
+
+    return compare(l, r) <=> 0;
+
+}
+#endif
+
+bool operator== (const BigInt& l, const BigInt& r) {
+
+    return l.negative == r.negative && l.magnitude == r.magnitude;
+
+}
+
+bool operator!= (const BigInt& l, const BigInt& r) {
+
+    return !(l == r);
+
+}
+
+bool operator< (const BigInt& l, const BigInt& r) {
+
+    return compare(l, r) < 0;
+
+}
+
+bool operator> (const BigInt& l, const BigInt& r) {
+
+    return compare(l, r) > 0;
+
+}
+
+bool operator<= (const BigInt& l, const BigInt& r) {
+
+    return compare(l, r) <= 0;
+
+}
+
+bool operator>= (const BigInt& l, const BigInt& r) {
+
+    return compare(l, r) >= 0;
+
+}
+
+// l += r when r_negative is the sign of r, lets -= not copy r to flip its sign
+inline BigInt& _add_signed(BigInt& l, const BigUnsigned& r, bool r_negative) {
+
+    if (l.negative == r_negative) {
+        l.magnitude = l.magnitude + r;
+    } else {
+        bool swapped;
+        l.magnitude = _abs_diff(l.magnitude, r, swapped); // one pass, the sign comes with it
+        if (swapped) {
+            l.negative = r_negative;
+        }
+    }
+    l.fix_sign();
+
+    return l;
+
+}
+
+// theta(max(l.size, r.size))
+BigInt& operator+= (BigInt& l, const BigInt& r) {
+
+    return _add_signed(l, r.magnitude, r.negative);
+
+}
+
+// theta(max(l.size, r.size))
+BigInt& operator-= (BigInt& l, const BigInt& r) {
+
+    return _add_signed(l, r.magnitude, !r.negative);
+
+}
+
+BigInt& operator*= (BigInt& l, const BigInt& r) {
+
+    l.magnitude = l.magnitude * r.magnitude;
+    l.negative = l.negative != r.negative;
+    l.fix_sign();
+
+    return l;
+
+}
+
+// returns quotient and remainder
+// Note: d must not be 0
+std::pair<BigInt, BigInt> divmod(const BigInt& n, const BigInt& d) {
+
+    auto qr = divmod(n.magnitude, d.magnitude);
+    return {BigInt(std::move(qr.first), n.negative != d.negative), BigInt(std::move(qr.second), n.negative)};
+
+}
+
+// Note: d must not be 0
+BigInt& operator/= (BigInt& l, const BigInt& r) {
+
+    l = divmod(l, r).first;
+    return l;
+
+}
+
+// Note: d must not be 0
+BigInt& operator%= (BigInt& l, const BigInt& r) {
+
+    l = divmod(l, r).second;
+    return l;
+
+}
+
+BigInt operator+ (BigInt l, const BigInt& r) {
+
+    return l += r;
+
+}
+
+BigInt operator- (BigInt l, const BigInt& r) {
+
+    return l -= r;
+
+}
+
+BigInt operator* (const BigInt& l, const BigInt& r) {
+
+    return BigInt(l.magnitude * r.magnitude, l.negative != r.negative);
+
+}
+
+BigInt operator/ (const BigInt& l, const BigInt& r) {
+
+    return divmod(l, r).first;
+
+}
+
+BigInt operator% (const BigInt& l, const BigInt& r) {
+
+    return divmod(l, r).second;
+
+}
+
+BigInt& operator++ (BigInt& num) {
+
+    if (num.negative) {
+        num.magnitude -= 1;
+        num.fix_sign();
+    } else {
+        num.magnitude += 1;
+    }
+    return num;
+
+}
+
+BigInt& operator-- (BigInt& num) {
+
+    if (num.negative || num.is_zero()) {
+        num.magnitude += 1;
+        num.negative = true;
+    } else {
+        num.magnitude -= 1;
+    }
+    return num;
+
+}
+
+BigInt operator++ (BigInt& num, int) {
+
+    BigInt res = num;
+    ++num;
+    return res;
+
+}
+
+BigInt operator-- (BigInt& num, int) {
+
+    BigInt res = num;
+    --num;
+    return res;
+
+}
+
+std::string to_string(const BigInt& num) {
+
+    return num.negative ? "-" + to_string(num.magnitude) : to_string(num.magnitude);
+
+}
+
+std::ostream& operator<< (std::ostream& out, const BigInt& num) {
+
+    if (num.negative) {
+        out << "-";
+    }
+    return out << num.magnitude;
+
+}
+
+namespace std {
+
+template<>
+struct hash<BigInt> {
+
+    std::size_t operator() (const BigInt& num) const noexcept {
+
+        return static_cast<std::size_t>(hash_limbs(num.magnitude.digits, num.negative ? 1 : 0));
+
+    }
+
+};
+
+}
+
+// Greatest common divisor
+//
+// Lehmer's algorithm, the leading 62 bits of both numbers run euclid's algorithm on native
+// integers for as long as the quotients are sure to be the same as for the full numbers,
+// then the steps taken are applied to the full numbers at once, about a digit each time
+// numbers fitting in 64 bits finish with binary gcd
+
+constexpr _ui LEHMER_BITS = 62; // leaves room for the cofactors added to the leading bits
+
+// the 64 bits of num starting at bit pos
+inline std::uint64_t _bits_at(LimbSpan<const limb> num, _ull pos) {
+
+    auto digit = [&num](_ull i) { return i < num.size() ? num[num.size() - 1 - i] : limb(0); };
+    const _ull index = pos / BASE_BIN_LENGTH;
+    const _ui shift = pos % BASE_BIN_LENGTH;
+    std::uint64_t res = digit(index) | (digit(index + 1) << BASE_BIN_LENGTH);
+    if (shift != 0) {
+        res = (res >> shift) | (digit(index + 2) << (2 * BASE_BIN_LENGTH - shift));
+    }
+    return res;
+
+}
+
+// gcd of two 64 bit integers, stein's algorithm
+inline std::uint64_t _binary_gcd(std::uint64_t l, std::uint64_t r) {
+
+    if (l == 0 || r == 0) {
+        return l | r;
     }
+    auto zeros = [](std::uint64_t num) {
+        _ui res = _trailing_zeros(num & LIMB_MASK);
+        return (num & LIMB_MASK) != 0 ? res : BASE_BIN_LENGTH + _trailing_zeros(num >> BASE_BIN_LENGTH);
+    };
+    const _ui shift = zeros(l | r);
+    l >>= zeros(l);
+    while (r != 0) {
+        r >>= zeros(r);
+        if (l > r) {
+            std::swap(l, r);
+        }
+        r -= l;
+    }
+    return l << shift;
+
+}
+
+// steps of euclid's algorithm on the leading bits of l >= r
+// the pair (l, r) becomes (a * l + b * r, c * l + d * r), every cofactor below BASE so it is one digit
+// a and b have opposite signs as do c and d, no steps leaves b == 0
+struct _LehmerStep {
+    std::int64_t a, b, c, d;
+};
 
+inline _LehmerStep _lehmer_step(LimbSpan<const limb> l, LimbSpan<const limb> r) {
+
+    const _ull bits = _bit_length(l);
+    const _ull pos = bits > LEHMER_BITS ? bits - LEHMER_BITS : 0;
+    auto x = static_cast<std::int64_t>(_bits_at(l, pos));
+    auto y = static_cast<std::int64_t>(_bits_at(r, pos));
+
+    // knuth's algorithm L, the quotient is only sure if both ends of the range the
+    // cofactors leave for the full numbers give it
+    _LehmerStep res{1, 0, 0, 1};
+    const std::int64_t limit = static_cast<std::int64_t>(LIMB_MASK);
+    while (y + res.c != 0 && y + res.d != 0) {
+        const std::int64_t q = (x + res.a) / (y + res.c);
+        if (q != (x + res.b) / (y + res.d)) {
+            break;
+        }
+        const std::int64_t next_c = res.a - q * res.c;
+        const std::int64_t next_d = res.b - q * res.d;
+        if (next_c > limit || next_c < -limit || next_d > limit || next_d < -limit) {
+            break;
+        }
+        res = {res.c, res.d, next_c, next_d};
+        const std::int64_t next_y = x - q * y;
+        x = y;
+        y = next_y;
+    }
     return res;
 
-}
\ No newline at end of file
+}
+
+// res = x * l + y * r for cofactors of a _LehmerStep, which is never negative
+// requires l.size() >= r.size(), scratch is reused between calls
+void _lehmer_combine(BigUnsigned& res, const BigUnsigned& l, const BigUnsigned& r, std::int64_t x, std::int64_t y, std::vector<limb>& scratch) {
+
+    const std::size_t n = l.digits.size() + 1;
+    res.digits.assign(n, 0);
+    scratch.assign(n, 0);
+    LimbSpan<limb> l_part(res.digits);
+    LimbSpan<limb> r_part = LimbSpan<limb>(scratch).last(r.digits.size() + 1);
+    l_part.front() = mul_limb(l_part.subspan(1), l.digits, static_cast<limb>(x < 0 ? -x : x));
+    r_part.front() = mul_limb(r_part.subspan(1), r.digits, static_cast<limb>(y < 0 ? -y : y));
+    if (x > 0) {
+        sub_limbs(res.digits, res.digits, scratch);
+    } else {
+        sub_limbs(res.digits, scratch, res.digits);
+    }
+
+    res.resize_to_fit();
+
+}
+
+// gcd(l, r), gcd(0, 0) is 0
+// theta(l.size * r.size)
+BigUnsigned gcd(BigUnsigned l, BigUnsigned r) {
+
+    if (l < r) {
+        std::swap(l, r);
+    }
+
+    BigUnsigned next_l;
+    BigUnsigned next_r;
+    std::vector<limb> scratch;
+    while (!r.digits.empty() && !fits_u64(l)) {
+        auto step = _lehmer_step(l.digits, r.digits);
+        if (step.b == 0) {
+            l = l % r;
+            std::swap(l, r);
+        } else {
+            _lehmer_combine(next_l, l, r, step.a, step.b, scratch);
+            _lehmer_combine(next_r, l, r, step.c, step.d, scratch);
+            std::swap(l, next_l);
+            std::swap(r, next_r);
+        }
+    }
+
+    if (r.digits.empty()) {
+        return l;
+    }
+    return BigUnsigned(_binary_gcd(to_u64(l), to_u64(r)));
+
+}
+
+// least common multiple, 0 if l or r is 0
+BigUnsigned lcm(const BigUnsigned& l, const BigUnsigned& r) {
+
+    if (l.digits.empty() || r.digits.empty()) {
+        return BigUnsigned();
+    }
+    return l / gcd(l, r) * r;
+
+}
+
+// {g, s, t} with g = gcd(l, r) = s * l + t * r
+// the cofactors of l follow every step and t is found with one division at the end
+std::tuple<BigUnsigned, BigInt, BigInt> gcdext(const BigUnsigned& l, const BigUnsigned& r) {
+
+    if (l < r) {
+        auto res = gcdext(r, l);
+        return {std::move(std::get<0>(res)), std::move(std::get<2>(res)), std::move(std::get<1>(res))};
+    }
+
+    BigUnsigned a = l;
+    BigUnsigned b = r;
+    BigInt s_a(1);
+    BigInt s_b(0);
+    BigUnsigned next_a;
+    BigUnsigned next_b;
+    std::vector<limb> scratch;
+    while (!b.digits.empty()) {
+        auto step = _lehmer_step(a.digits, b.digits);
+        if (step.b == 0) {
+            auto qr = divmod(a, b);
+            a = std::move(b);
+            b = std::move(qr.second);
+            s_a -= BigInt(std::move(qr.first)) * s_b;
+            std::swap(s_a, s_b);
+        } else {
+            _lehmer_combine(next_a, a, b, step.a, step.b, scratch);
+            _lehmer_combine(next_b, a, b, step.c, step.d, scratch);
+            std::swap(a, next_a);
+            std::swap(b, next_b);
+            BigInt next_s = BigInt(step.a) * s_a + BigInt(step.b) * s_b;
+            s_b = BigInt(step.c) * s_a + BigInt(step.d) * s_b;
+            s_a = std::move(next_s);
+        }
+    }
+
+    BigInt t;
+    if (!r.digits.empty()) {
+        t = (BigInt(a) - s_a * BigInt(l)) / BigInt(r);
+    }
+    return {std::move(a), std::move(s_a), std::move(t)};
+
+}
+
+// a^-1 mod m, a * invert(a, m) % m == 1
+// throws std::domain_error if a and m are not coprime
+// Note: m must not be 0
+BigUnsigned invert(const BigUnsigned& a, const BigUnsigned& m) {
+
+    if (m.digits.size() == 1 && m.digits.front() == 1) {
+        return BigUnsigned();
+    }
+
+    auto res = gcdext(a % m, m);
+    if (std::get<0>(res) != BigUnsigned(1u)) {
+        throw std::domain_error("BigUnsigned has no inverse modulo a number it shares a factor with");
+    }
+    const BigInt& s = std::get<1>(res); // |s| < m
+    return s.negative ? m - s.magnitude : s.magnitude;
+
+}
+
+// Chinese remainder theorem
+//
+// the moduli are the leaves of a balanced product tree, every node keeps the product of the
+// moduli below it and the inverse of its left product modulo its right product
+// combining at a node only works modulo the right product, so the multiplications
+// are between numbers of about the same size
+
+// x below the product of pairwise coprime moduli from x % moduli[i] for every i
+// made once for a set of moduli and used for any number of residues
+class CrtTree {
+public:
+
+    // throws std::domain_error if two moduli are not coprime
+    // Note: no modulus may be 0
+    explicit CrtTree(std::vector<BigUnsigned> moduli) : moduli_(std::move(moduli)) {
+
+        if (!moduli_.empty()) {
+            nodes.reserve(2 * moduli_.size() - 1);
+            _build(0, moduli_.size());
+        }
+
+    }
+
+    std::size_t size() const { return moduli_.size(); }
+
+    const std::vector<BigUnsigned>& moduli() const { return moduli_; }
+
+    // product of every modulus, 1 if there are none
+    BigUnsigned product() const {
+
+        return nodes.empty() ? BigUnsigned(1u) : nodes.front().product;
+
+    }
+
+    // the x below product() with x % moduli()[i] == residues[i] % moduli()[i]
+    // requires residues.size() == size()
+    BigUnsigned combine(const std::vector<BigUnsigned>& residues) const {
+
+        if (nodes.empty()) {
+            return BigUnsigned();
+        }
+        return _combine(residues, 0, moduli_.size(), 0);
+
+    }
+
+private:
+
+    struct _Node {
+        BigUnsigned product;
+        BigUnsigned inverse; // left product^-1 mod right product
+        std::size_t left;
+        std::size_t right;
+    };
+
+    // node for moduli [first, last), returns its index
+    std::size_t _build(std::size_t first, std::size_t last) {
+
+        const std::size_t index = nodes.size();
+        nodes.push_back(_Node{BigUnsigned(), BigUnsigned(), 0, 0});
+        if (last - first == 1) {
+            nodes[index].product = moduli_[first];
+            return index;
+        }
+
+        const std::size_t mid = first + (last - first) / 2;
+        const std::size_t left = _build(first, mid);
+        const std::size_t right = _build(mid, last);
+        nodes[index].inverse = invert(nodes[left].product, nodes[right].product);
+        nodes[index].product = nodes[left].product * nodes[right].product;
+        nodes[index].left = left;
+        nodes[index].right = right;
+        return index;
+
+    }
+
+    // x mod the product of node from the residues for moduli [first, last)
+    // x = x_left + left product * ((x_right - x_left) * inverse mod right product)
+    BigUnsigned _combine(const std::vector<BigUnsigned>& residues, std::size_t first, std::size_t last, std::size_t index) const {
+
+        const _Node& node = nodes[index];
+        if (last - first == 1) {
+            return residues[first] % node.product;
+        }
+
+        const std::size_t mid = first + (last - first) / 2;
+        BigUnsigned x_left = _combine(residues, first, mid, node.left);
+        BigUnsigned x_right = _combine(residues, mid, last, node.right);
+        const BigUnsigned& right_product = nodes[node.right].product;
+        BigUnsigned left_mod = x_left % right_product;
+        if (x_right < left_mod) {
+            x_right = x_right + right_product;
+        }
+        BigUnsigned diff = (x_right - left_mod) * node.inverse % right_product;
+        return x_left + nodes[node.left].product * diff;
+
+    }
+
+    std::vector<BigUnsigned> moduli_;
+    std::vector<_Node> nodes; // nodes.front() is the root
+
+};
+
+// x below the product of the moduli with x % moduli[i] == residues[i] % moduli[i]
+// makes a CrtTree, keep one to combine many sets of residues for the same moduli
+// throws std::domain_error if two moduli are not coprime
+BigUnsigned crt(const std::vector<BigUnsigned>& residues, const std::vector<BigUnsigned>& moduli) {
+
+    return CrtTree(moduli).combine(residues);
+
+}
@@ -0,0 +1,417 @@
+// Author: Dennis Yakovlev
+#pragma once
+#include <BigInt.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Binary format for one or more BigUnsigned, every field is little endian
+//
+// bytes [0, 8)   magic "BIGUNSGN"
+// bytes [8, 12)  format version
+// bytes [12, 16) bytes per stored digit, sizeof(_ull)
+// bytes [16, 20) bits used per digit, BASE_BIN_LENGTH
+// bytes [20, 24) reserved, always 0
+// bytes [24, 32) number of values stored, count
+//
+// followed by count + 1 offsets of 8 bytes each, offset i is the index of the first digit
+// of value i in the digit area and offset count is the total number of digits
+// offset 0 is always 0 and offsets never decrease
+//
+// followed by the digits of every value, in the same order as BigUnsigned::digits
+// (most significant first) so a mapped file can be viewed without copying
+//
+// header and offsets are multiples of 8 bytes so digits stay aligned in a mapped file
+
+constexpr char FILE_MAGIC[8] = {'B', 'I', 'G', 'U', 'N', 'S', 'G', 'N'};
+constexpr std::uint32_t FILE_VERSION = 1;
+constexpr std::size_t FILE_HEADER_BYTES = 32;
+constexpr std::size_t FILE_READ_DIGITS = 1 << 16; // digits are read this many at a time so a bad length cannot allocate much
+
+inline bool _host_little_endian() {
+
+    const std::uint32_t one = 1;
+    unsigned char first;
+    std::memcpy(&first, &one, 1);
+    return first == 1;
+
+}
+
+inline void _put_le(unsigned char* out, std::uint64_t val, _ui bytes) {
+
+    for (_ui i = 0; i != bytes; ++i, val >>= 8) {
+        out[i] = static_cast<unsigned char>(val & 0xFF);
+    }
+
+}
+
+inline std::uint64_t _get_le(const unsigned char* in, _ui bytes) {
+
+    std::uint64_t res = 0;
+    for (_ui i = bytes; i != 0; --i) {
+        res = (res << 8) | in[i - 1];
+    }
+    return res;
+
+}
+
+// write values [first, last) to out
+// Forward must be multipass with value_type BigUnsigned
+template<typename Forward>
+bool save(std::ostream& out, Forward first, Forward last) {
+
+    unsigned char header[FILE_HEADER_BYTES] = {};
+    std::memcpy(header, FILE_MAGIC, sizeof(FILE_MAGIC));
+    _put_le(header + 8, FILE_VERSION, 4);
+    _put_le(header + 12, sizeof(_ull), 4);
+    _put_le(header + 16, BASE_BIN_LENGTH, 4);
+    _put_le(header + 24, static_cast<std::uint64_t>(std::distance(first, last)), 8);
+    out.write(reinterpret_cast<const char*>(header), FILE_HEADER_BYTES);
+
+    unsigned char field[sizeof(_ull)];
+    std::uint64_t offset = 0;
+    for (auto iter = first; iter != last; ++iter) {
+        _put_le(field, offset, 8);
+        out.write(reinterpret_cast<const char*>(field), 8);
+        offset += iter->digits.size();
+    }
+    _put_le(field, offset, 8);
+    out.write(reinterpret_cast<const char*>(field), 8);
+
+    const bool little = _host_little_endian();
+    for (auto iter = first; iter != last; ++iter) {
+        if (little) {
+            out.write(reinterpret_cast<const char*>(iter->digits.data()), iter->digits.size() * sizeof(_ull));
+        } else {
+            for (auto digit : iter->digits) {
+                _put_le(field, digit, sizeof(_ull));
+                out.write(reinterpret_cast<const char*>(field), sizeof(_ull));
+            }
+        }
+    }
+
+    return static_cast<bool>(out);
+
+}
+
+bool save(std::ostream& out, const BigUnsigned& num) {
+
+    return save(out, &num, &num + 1);
+
+}
+
+// true if digits are all below BASE and the first is not 0
+inline bool _valid_digits(const _ull* digits, std::size_t size) {
+
+    if (size != 0 && digits[0] == 0) {
+        return false;
+    }
+    for (std::size_t i = 0; i != size; ++i) {
+        if (digits[i] > LIMB_MASK) {
+            return false;
+        }
+    }
+    return true;
+
+}
+
+// read every value stored in the binary format from in
+// on failure, including digits that are not below BASE or leading zeros, returns false and
+// leaves nums unchanged
+bool load(std::istream& in, std::vector<BigUnsigned>& nums) {
+
+    unsigned char header[FILE_HEADER_BYTES];
+    if (!in.read(reinterpret_cast<char*>(header), FILE_HEADER_BYTES) ||
+        std::memcmp(header, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 ||
+        _get_le(header + 8, 4) != FILE_VERSION ||
+        _get_le(header + 12, 4) != sizeof(_ull) ||
+        _get_le(header + 16, 4) != BASE_BIN_LENGTH) {
+        return false;
+    }
+    std::uint64_t count = _get_le(header + 24, 8);
+
+    std::vector<std::uint64_t> offsets;
+    unsigned char field[sizeof(_ull)];
+    for (std::uint64_t i = 0; i <= count; ++i) {
+        if (!in.read(reinterpret_cast<char*>(field), 8)) {
+            return false;
+        }
+        offsets.push_back(_get_le(field, 8));
+        if (i == 0 ? offsets[i] != 0 : offsets[i] < offsets[i - 1]) {
+            return false;
+        }
+    }
+
+    // every offset was read, so count is bounded by the stream
+    const bool little = _host_little_endian();
+    std::vector<BigUnsigned> res;
+    res.reserve(count);
+    for (std::uint64_t i = 0; i != count; ++i) {
+        // grown as digits arrive, a length past the end of the stream fails before it is allocated
+        BigUnsigned num;
+        for (std::uint64_t left = offsets[i + 1] - offsets[i]; left != 0;) {
+            const std::size_t read = static_cast<std::size_t>(std::min<std::uint64_t>(left, FILE_READ_DIGITS));
+            const std::size_t start = num.digits.size();
+            num.digits.resize(start + read);
+            if (!in.read(reinterpret_cast<char*>(num.digits.data() + start), read * sizeof(_ull))) {
+                return false;
+            }
+            left -= read;
+        }
+        if (!little) {
+            for (auto& digit : num.digits) {
+                unsigned char bytes[sizeof(_ull)];
+                std::memcpy(bytes, &digit, sizeof(_ull));
+                digit = _get_le(bytes, sizeof(_ull));
+            }
+        }
+        if (!_valid_digits(num.digits.data(), num.digits.size())) {
+            return false;
+        }
+        res.push_back(std::move(num));
+    }
+
+    nums = std::move(res);
+    return true;
+
+}
+
+// read a file holding exactly one value
+bool load(std::istream& in, BigUnsigned& num) {
+
+    std::vector<BigUnsigned> nums;
+    if (!load(in, nums) || nums.size() != 1) {
+        return false;
+    }
+    num = std::move(nums.front());
+    return true;
+
+}
+
+// view over a buffer holding the binary format, no digits are copied
+// buffer must be aligned to _ull and outlive the view
+// views can only be made on little endian hosts, otherwise use load
+// the header and offsets are checked and the buffer must end with the last digit, the digits
+// themselves are trusted, call validate before using a file that may be corrupt
+class BigUnsignedArrayView {
+public:
+
+    using size_type = BigUnsigned::sz_ty_ull;
+
+    BigUnsignedArrayView() : offsets(nullptr), digits(nullptr), count(0), ok(false) {}
+
+    BigUnsignedArrayView(const void* const buffer, std::size_t bytes) : BigUnsignedArrayView() {
+
+        auto start = static_cast<const unsigned char*>(buffer);
+        if (!_host_little_endian() || reinterpret_cast<std::uintptr_t>(start) % alignof(_ull) != 0 ||
+            bytes < FILE_HEADER_BYTES + 8 ||
+            std::memcmp(start, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 ||
+            _get_le(start + 8, 4) != FILE_VERSION ||
+            _get_le(start + 12, 4) != sizeof(_ull) ||
+            _get_le(start + 16, 4) != BASE_BIN_LENGTH) {
+            return;
+        }
+
+        std::uint64_t num = _get_le(start + 24, 8);
+        if (num >= (bytes - FILE_HEADER_BYTES) / 8) {
+            return;
+        }
+        auto table = reinterpret_cast<const std::uint64_t*>(start + FILE_HEADER_BYTES);
+        std::size_t digit_bytes = bytes - FILE_HEADER_BYTES - (num + 1) * 8;
+        if (table[0] != 0) {
+            return;
+        }
+        for (std::uint64_t i = 0; i != num; ++i) {
+            if (table[i + 1] < table[i]) {
+                return;
+            }
+        }
+        // the digit area must be exactly the digits the offsets cover, no trailing bytes
+        if (digit_bytes % sizeof(_ull) != 0 || table[num] != digit_bytes / sizeof(_ull)) {
+            return;
+        }
+
+        offsets = table;
+        digits = reinterpret_cast<const _ull*>(start + FILE_HEADER_BYTES + (num + 1) * 8);
+        count = static_cast<size_type>(num);
+        ok = true;
+
+    }
+
+    bool valid() const { return ok; }
+
+    // true if the header is valid and every value has digits below BASE and no leading zeros
+    // reads every digit
+    bool validate() const {
+
+        if (!ok) {
+            return false;
+        }
+        for (size_type i = 0; i != count; ++i) {
+            if (!_valid_digits(digits + offsets[i], static_cast<std::size_t>(offsets[i + 1] - offsets[i]))) {
+                return false;
+            }
+        }
+        return true;
+
+    }
+    size_type size() const { return count; }
+
+    BigUnsignedView operator[] (size_type i) const {
+
+        return BigUnsignedView(digits + offsets[i], static_cast<BigUnsignedView::size_type>(offsets[i + 1] - offsets[i]));
+
+    }
+
+private:
+
+    const std::uint64_t* offsets;
+    const _ull* digits;
+    size_type count;
+    bool ok;
+
+};
+
+// read only memory map of a file in the binary format
+// views taken from it are valid until the file is closed
+class BigUnsignedFile {
+public:
+
+    BigUnsignedFile() : base(nullptr), bytes(0) {}
+
+    explicit BigUnsignedFile(const std::string& path) : BigUnsignedFile() {
+
+        open(path);
+
+    }
+
+    BigUnsignedFile(const BigUnsignedFile&) = delete;
+    BigUnsignedFile& operator= (const BigUnsignedFile&) = delete;
+
+    BigUnsignedFile(BigUnsignedFile&& other) : base(other.base), bytes(other.bytes), arr(other.arr) {
+
+        other.base = nullptr;
+        other.bytes = 0;
+        other.arr = BigUnsignedArrayView();
+
+    }
+
+    BigUnsignedFile& operator= (BigUnsignedFile&& other) {
+
+        if (this != &other) {
+            close();
+            std::swap(base, other.base);
+            std::swap(bytes, other.bytes);
+            std::swap(arr, other.arr);
+        }
+        return *this;
+
+    }
+
+    ~BigUnsignedFile() {
+
+        close();
+
+    }
+
+    // map path, returns true if the file holds a valid binary format
+    bool open(const std::string& path) {
+
+        close();
+
+#if defined(_WIN32)
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+            CloseHandle(file);
+            return false;
+        }
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (mapping == nullptr) {
+            return false;
+        }
+        void* start = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping); // view keeps the mapping alive
+        if (start == nullptr) {
+            return false;
+        }
+        bytes = static_cast<std::size_t>(size.QuadPart);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd == -1) {
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0) {
+            ::close(fd);
+            return false;
+        }
+        void* start = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // mapping stays valid after the descriptor is closed
+        if (start == MAP_FAILED) {
+            return false;
+        }
+        bytes = static_cast<std::size_t>(info.st_size);
+#endif
+
+        base = start;
+        arr = BigUnsignedArrayView(base, bytes);
+        if (!arr.valid()) {
+            close();
+            return false;
+        }
+        return true;
+
+    }
+
+    void close() {
+
+        if (base != nullptr) {
+#if defined(_WIN32)
+            UnmapViewOfFile(base);
+#else
+            munmap(base, bytes);
+#endif
+        }
+        base = nullptr;
+        bytes = 0;
+        arr = BigUnsignedArrayView();
+
+    }
+
+    bool is_open() const { return base != nullptr; }
+
+    const BigUnsignedArrayView& view() const { return arr; }
+    BigUnsignedArrayView::size_type size() const { return arr.size(); }
+    BigUnsignedView operator[] (BigUnsignedArrayView::size_type i) const { return arr[i]; }
+
+private:
+
+    void* base;
+    std::size_t bytes;
+    BigUnsignedArrayView arr;
+
+};
@@ -1,12 +1,14 @@
 // Author: Dennis Yakovlev
 #pragma once
-#include <ver6.h> // include latest working version
-                  // change to BigInt.h
+#include <BigInt.h>
+#include <BigIntFile.h>
 #include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <sstream>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 using ull = unsigned long long;
@@ -92,7 +94,39 @@ std::map<id_ty, str> messages {
     {15, "two numbers can be multiplied"},
     {16, "two numbers with zero digits throughout can be multiplied"},
 
-    {17, "two numbers can be divided"}
+    {17, "two numbers can be divided"},
+
+    {18, "numbers can be saved and loaded in the binary format"},
+    {19, "numbers can be viewed in the binary format without copying"},
+
+    {20, "two numbers can be divided with remainder"},
+    {21, "kernels work on memory not owned by a BigUnsigned"},
+
+    {22, "numbers can be converted to base 10"},
+
+    {23, "numbers can be converted to and from floating point"},
+
+    {24, "numbers can be converted to and from native integers"},
+
+    {25, "numbers can be added, subtracted and multiplied by native integers"},
+    {26, "kernels agree at every cpu level"},
+    {27, "vector kernels compare, mask, shift and multiply by a digit"},
+    {28, "numbers can be shifted, masked and have their bits read and set"},
+    {29, "numbers compare in one pass"},
+    {30, "numbers hash by value"},
+    {31, "signed numbers keep their sign through arithmetic"},
+    {32, "powers can be taken modulo a number"},
+    {33, "residues can be multiplied, added and subtracted modulo a fixed number"},
+    {34, "numbers can be raised to a power"},
+    {35, "greatest common divisors can be found"},
+    {36, "inverses and chinese remainders can be found"},
+    {37, "roots can be taken"},
+    {38, "primes can be found"},
+    {39, "factorials and binomials can be found"},
+    {40, "ranges can be multiplied and added"},
+    {41, "fibonacci and lucas numbers can be found"},
+    {42, "products can be split between threads"},
+    {43, "base 10 conversion can be split between threads"}
 };
 
 // information for failed test
@@ -164,6 +198,15 @@ void insert_result(Test_Info info, BigUnsigned result, vec expected) {
 
 }
 
+// insert result of a test which only passes or fails
+void insert_result(Test_Info info, result_ty passed) {
+
+    if (!passed) {
+        failures.push_back(Info(info, Fail_Info(vec{1}, vec{0})));
+    }
+
+}
+
 // instantiation tests
 
 void test_1_1() {
@@ -445,6 +488,887 @@ void test_17_4() {
 
 }
 
+// binary format tests
+
+void test_18_1() {
+
+    std::stringstream ss;
+    save(ss, BigUnsigned(num_zero_middle_multiple));
+    BigUnsigned num_1;
+    load(ss, num_1);
+    vec vec_1 = arr_zero_middle_multiple;
+
+    insert_result(Test_Info(18, 1), num_1, vec_1);
+
+}
+
+void test_18_2() {
+
+    std::vector<BigUnsigned> nums {BigUnsigned(num_normal_1), BigUnsigned(num_zero), BigUnsigned(num_nine_nine)};
+    std::stringstream ss;
+    save(ss, nums.cbegin(), nums.cend());
+    std::vector<BigUnsigned> loaded;
+    load(ss, loaded);
+    BigUnsigned num_1 = loaded.size() == 3 ? loaded[2] : BigUnsigned();
+    vec vec_1 = arr_nine_nine;
+
+    insert_result(Test_Info(18, 2), num_1, vec_1);
+
+}
+
+void test_18_3() {
+
+    std::stringstream ss;
+    save(ss, BigUnsigned(num_normal_3)); // 2 digits, the digit area starts at byte 48
+    std::string bytes = ss.str();
+
+    std::string huge = bytes.substr(0, 48);
+    _put_le(reinterpret_cast<unsigned char*>(&huge[40]), std::uint64_t(1) << 40, 8); // 2^40 digits
+    std::stringstream ss_huge(huge);
+    std::vector<BigUnsigned> loaded;
+    result_ty passed = !load(ss_huge, loaded);
+
+    std::string bad = bytes;
+    _put_le(reinterpret_cast<unsigned char*>(&bad[48]), 0, 8); // leading zero
+    _put_le(reinterpret_cast<unsigned char*>(&bad[56]), 0xFFFFFFFFFFull, 8); // not below BASE
+    std::stringstream ss_bad(bad);
+    passed = passed && !load(ss_bad, loaded) && loaded.empty();
+
+    std::vector<_ull> buffer(bad.size() / sizeof(_ull)); // aligned copy of the file
+    std::memcpy(buffer.data(), bad.data(), bad.size());
+    BigUnsignedArrayView arr(buffer.data(), bad.size());
+    passed = passed && arr.valid() && !arr.validate();
+
+    insert_result(Test_Info(18, 3), passed);
+
+}
+
+void test_18_4() {
+
+    std::vector<BigUnsigned> nums {BigUnsigned(5u), BigUnsigned(7u)};
+    std::stringstream ss;
+    save(ss, nums.cbegin(), nums.cend()); // offsets at bytes 32, 40 and 48, digits from byte 56
+    std::string bytes = ss.str();
+
+    std::string shifted = bytes;
+    _put_le(reinterpret_cast<unsigned char*>(&shifted[32]), 1, 8); // offset 0 must be 0
+    std::stringstream ss_shifted(shifted);
+    std::vector<BigUnsigned> loaded;
+    result_ty passed = !load(ss_shifted, loaded) && loaded.empty();
+
+    std::vector<_ull> buffer(shifted.size() / sizeof(_ull) + 1); // aligned copy of the file
+    std::memcpy(buffer.data(), shifted.data(), shifted.size());
+    passed = passed && !BigUnsignedArrayView(buffer.data(), shifted.size()).valid();
+
+    std::memcpy(buffer.data(), bytes.data(), bytes.size());
+    passed = passed && BigUnsignedArrayView(buffer.data(), bytes.size()).valid() &&
+             !BigUnsignedArrayView(buffer.data(), bytes.size() + sizeof(_ull)).valid(); // trailing digit
+
+    insert_result(Test_Info(18, 4), passed);
+
+}
+
+void test_19_1() {
+
+    std::vector<BigUnsigned> nums {BigUnsigned(num_normal_1), BigUnsigned(num_zero_end), BigUnsigned(num_normal_3)};
+    std::stringstream ss;
+    save(ss, nums.cbegin(), nums.cend());
+    std::string bytes = ss.str();
+    std::vector<_ull> buffer(bytes.size() / sizeof(_ull) + 1); // aligned copy of the file
+    std::memcpy(buffer.data(), bytes.data(), bytes.size());
+    BigUnsignedArrayView arr(buffer.data(), bytes.size());
+    BigUnsigned num_1 = arr.valid() && arr.size() == 3 ? BigUnsigned(arr[1]) : BigUnsigned();
+    vec vec_1 = arr_zero_end;
+
+    insert_result(Test_Info(19, 1), num_1, vec_1);
+
+}
+
+// remainder tests
+
+void test_20_1() {
+
+    BigUnsigned num_1 = BigUnsigned(num_normal_1) % BigUnsigned(num_normal_2);
+    vec vec_1 = {215, 2779860975, 4270990599, 3274589400, 3269138151};
+
+    insert_result(Test_Info(20, 1), num_1, vec_1);
+
+}
+
+void test_20_2() {
+
+    BigUnsigned num_1 = BigUnsigned(num_normal_3) / BigUnsigned(num_normal_1);
+    vec vec_1 = {};
+
+    insert_result(Test_Info(20, 2), num_1, vec_1);
+
+}
+
+// kernel tests
+
+void test_21_1() {
+
+    limb l[3] = {721, 0, 4294967295};
+    limb r[2] = {4294967295, 1};
+    limb res[3];
+    limb carry = add_limbs(LimbSpan<limb>(res, 3), LimbSpan<const limb>(l, 3), LimbSpan<const limb>(r, 2));
+    BigUnsigned num_1(BigUnsignedView(res, 3));
+    num_1.digits.insert(num_1.digits.cbegin(), carry);
+    vec vec_1 = {722, 0, 0};
+
+    insert_result(Test_Info(21, 1), num_1, vec_1);
+
+}
+
+void test_21_2() {
+
+    BigUnsigned n(num_zero_middle_multiple);
+    BigUnsigned d(num_normal_3);
+    BigUnsigned q(zero_digits, n.digits.size() - d.digits.size() + 1);
+    BigUnsigned r(zero_digits, d.digits.size());
+    divmod_limbs(q.digits, r.digits, BigUnsignedView(n), BigUnsignedView(d));
+    BigUnsigned num_1 = q * d + r;
+    vec vec_1 = arr_zero_middle_multiple;
+
+    insert_result(Test_Info(21, 2), num_1, vec_1);
+
+}
+
+// base 10 conversion tests
+
+void test_22_1() {
+
+    insert_result(Test_Info(22, 1), to_string(BigUnsigned(num_zero_middle_multiple)) == num_zero_middle_multiple);
+
+}
+
+void test_22_2() {
+
+    str num_1(2000, '9'); // large enough to be split in halves
+    num_1 += num_nine_digits;
+
+    insert_result(Test_Info(22, 2), to_string(BigUnsigned(num_1)) == num_1);
+
+}
+
+void test_22_3() {
+
+    insert_result(Test_Info(22, 3), to_string(BigUnsigned(num_zero)) == num_zero);
+
+}
+
+// floating point conversion tests
+
+void test_23_1() {
+
+    // 2^53 + 1 is a tie between 2^53 and 2^53 + 2, rounds to even
+    insert_result(Test_Info(23, 1), to_double(BigUnsigned("9007199254740993")) == 9007199254740992.0);
+
+}
+
+void test_23_2() {
+
+    insert_result(Test_Info(23, 2), to_double(BigUnsigned(str(400, '9'))) == std::numeric_limits<double>::infinity());
+
+}
+
+void test_23_3() {
+
+    BigUnsigned num_1(1e30);
+    vec vec_1 = {12, 2670501072, 1182072832, 0}; // 1e30 as a double is 1000000000000000019884624838656
+
+    insert_result(Test_Info(23, 3), num_1, vec_1);
+
+}
+
+// native integer conversion tests
+
+void test_24_1() {
+
+    BigUnsigned num_1(18446744073709551615ull);
+    vec vec_1 = {4294967295, 4294967295};
+
+    insert_result(Test_Info(24, 1), num_1, vec_1);
+
+}
+
+void test_24_2() {
+
+    BigUnsigned num_1(0u);
+    vec vec_1 = {};
+
+    insert_result(Test_Info(24, 2), num_1, vec_1);
+
+}
+
+void test_24_3() {
+
+    BigUnsigned num_1(num_normal_3);
+
+    insert_result(Test_Info(24, 3), fits_u64(num_1) && to_u64(num_1) == 4682732413442ull && !fits_u64(BigUnsigned(num_normal_2)));
+
+}
+
+// native integer arithmetic tests
+
+void test_25_1() {
+
+    BigUnsigned num_1(num_nine_nine);
+    num_1 += 18446744073709551615ull;
+    num_1 -= 4294967296ull;
+    vec vec_1 = {999999999, 999999999, 1000000000, 999999998, 999999998};
+
+    insert_result(Test_Info(25, 1), num_1, vec_1);
+
+}
+
+void test_25_2() {
+
+    BigUnsigned num_1 = BigUnsigned(num_normal_3) * 4294967296ull;
+    vec vec_1 = {1090, 1218060802, 0};
+
+    insert_result(Test_Info(25, 2), num_1, vec_1);
+
+}
+
+void test_25_3() {
+
+    BigUnsigned num_1 = 5 - BigUnsigned(num_one); // doesnt care about order
+    vec vec_1 = {4};
+
+    insert_result(Test_Info(25, 3), num_1, vec_1);
+
+}
+
+// cpu dispatch tests
+
+void test_26_1() {
+
+    BigUnsigned num_1(num_zero_middle_multiple + num_zero_middle_multiple); // long enough for the word kernels
+    BigUnsigned num_2 = num_1;
+    const CpuLevel prev = cpu_level();
+    result_ty passed = true;
+    for (auto level : {CpuLevel::generic, CpuLevel::words, CpuLevel::bmi2, CpuLevel::avx2, CpuLevel::avx512}) {
+        if (set_cpu_level(level)) {
+            passed = passed && (num_1 * num_1).digits == (num_1 * num_2).digits;
+        }
+    }
+    set_cpu_level(prev);
+
+    insert_result(Test_Info(26, 1), passed);
+
+}
+
+void test_26_2() {
+
+    const CpuLevel prev = cpu_level();
+    result_ty passed = set_cpu_level(CpuLevel::generic) && cpu_level() == CpuLevel::generic;
+    set_cpu_level(prev);
+    passed = passed && cpu_level() == prev && prev <= cpu_level_supported();
+
+    insert_result(Test_Info(26, 2), passed);
+
+}
+
+void test_26_3() {
+
+    limb num[2] = {4294967295, 4294967295};
+    limb res[4];
+    sqr_limbs(LimbSpan<limb>(res, 4), LimbSpan<const limb>(num, 2));
+    BigUnsigned num_1(BigUnsignedView(res, 4));
+    vec vec_1 = {4294967295, 4294967294, 0, 1};
+
+    insert_result(Test_Info(26, 3), num_1, vec_1);
+
+}
+
+// vector kernel tests
+
+void test_27_1() {
+
+    BigUnsigned num_1(num_zero_middle_multiple + num_zero_middle_multiple);
+    BigUnsigned num_2 = num_1;
+    num_2.digits.back() += 1;
+    const CpuLevel prev = cpu_level();
+    result_ty passed = true;
+    for (auto level : {CpuLevel::generic, CpuLevel::avx2, CpuLevel::avx512}) {
+        if (set_cpu_level(level)) {
+            passed = passed && compare_limbs(num_1.digits, num_2.digits) < 0 && compare_limbs(num_2.digits, num_1.digits) > 0 &&
+                     compare_limbs(num_1.digits, num_1.digits) == 0;
+        }
+    }
+    set_cpu_level(prev);
+
+    insert_result(Test_Info(27, 1), passed);
+
+}
+
+void test_27_2() {
+
+    limb l[9] = {1, 2, 3, 4, 5, 6, 7, 8, 4294967295};
+    limb r[9] = {3, 3, 3, 3, 3, 3, 3, 3, 2147483648};
+    limb res[9];
+    and_limbs(LimbSpan<limb>(res, 9), LimbSpan<const limb>(l, 9), LimbSpan<const limb>(r, 9));
+    xor_limbs(LimbSpan<limb>(res, 9), LimbSpan<const limb>(res, 9), LimbSpan<const limb>(l, 9));
+    limb out = shl_limbs(LimbSpan<limb>(res, 9), LimbSpan<const limb>(res, 9), 31);
+    BigUnsigned num_1(BigUnsignedView(res, 9));
+    num_1.digits.insert(num_1.digits.cbegin(), out);
+    vec vec_1 = {2, 2, 2, 2, 4, 1073741823, 2147483648};
+
+    insert_result(Test_Info(27, 2), num_1, vec_1);
+
+}
+
+void test_27_3() {
+
+    BigUnsigned num_1(num_zero_middle_multiple + num_zero_middle_multiple);
+    const CpuLevel prev = cpu_level();
+    set_cpu_level(CpuLevel::generic);
+    BigUnsigned num_2 = num_1 * 4294967295ull;
+    set_cpu_level(prev);
+    num_1 *= 4294967295ull;
+
+    insert_result(Test_Info(27, 3), num_1, num_2.digits);
+
+}
+
+// bit operation tests
+
+void test_28_1() {
+
+    BigUnsigned num_1 = BigUnsigned(num_zero_middle_multiple) << 77;
+    vec vec_1 = {5906432, 35700736, 0, 0, 127401984, 0, 0, 5, 2564186112, 0, 0};
+
+    insert_result(Test_Info(28, 1), num_1, vec_1);
+
+}
+
+void test_28_2() {
+
+    BigUnsigned num_1(num_zero_middle_multiple);
+    num_1 <<= 77;
+    num_1 >>= 122;
+    vec vec_1 = {378011648, 2284847104, 0, 1, 3858759680, 0, 0};
+
+    insert_result(Test_Info(28, 2), num_1, vec_1);
+
+}
+
+void test_28_3() {
+
+    BigUnsigned num_1 = BigUnsigned(num_normal_1) ^ BigUnsigned(num_normal_2);
+    vec vec_1 = {498273891, 1183, 3437238407, 2937202424, 3824951024, 3710801402};
+
+    insert_result(Test_Info(28, 3), num_1, vec_1);
+
+}
+
+void test_28_4() {
+
+    BigUnsigned num_1 = BigUnsigned(num_normal_1) & BigUnsigned(num_normal_2);
+    vec vec_1 = {288, 17777736, 5015814, 67240202, 578849285};
+
+    insert_result(Test_Info(28, 4), num_1, vec_1);
+
+}
+
+void test_28_5() {
+
+    BigUnsigned num_1 = ~BigUnsigned(num_normal_1); // only bits below the highest set bit
+    vec vec_1 = {38597020, 4294965824, 4275092404, 4204875881, 4213039797, 3377668568};
+
+    insert_result(Test_Info(28, 5), num_1, vec_1);
+
+}
+
+void test_28_6() {
+
+    BigUnsigned num_1(num_normal_1);
+    BigUnsigned num_2 = num_1 << 77;
+    BigUnsigned num_3;
+    set_bit(num_3, 100);
+    result_ty passed = popcount(num_1) == 84 && bit_length(num_1) == 189 && count_trailing_zeros(num_2) == 77 &&
+                       test_bit(num_2, 77) && !test_bit(num_2, 76) && bit_length(num_3) == 101;
+    set_bit(num_3, 100, false);
+
+    insert_result(Test_Info(28, 6), passed && compare_test_zero(num_3));
+
+}
+
+// comparison tests
+
+void test_29_1() {
+
+    BigUnsigned num_1(num_normal_1);
+    BigUnsigned num_2(num_normal_2);
+    result_ty passed = num_2 < num_1 && num_1 > num_2 && num_2 <= num_1 && num_1 >= num_2 && num_1 != num_2 &&
+                       !(num_1 < num_2) && !(num_1 <= num_2) && compare(num_1, num_2) > 0 && compare(num_2, num_1) < 0;
+
+    insert_result(Test_Info(29, 1), passed);
+
+}
+
+void test_29_2() {
+
+    BigUnsigned num_1(num_zero_middle_multiple);
+    BigUnsigned num_2(num_zero_middle_multiple);
+    result_ty passed = num_1 == num_2 && num_1 <= num_2 && num_1 >= num_2 && !(num_1 < num_2) && !(num_1 > num_2) &&
+                       compare(num_1, num_2) == 0 && BigUnsigned() == BigUnsigned() && BigUnsigned() < num_1;
+
+    insert_result(Test_Info(29, 2), passed);
+
+}
+
+void test_29_3() {
+
+    BigUnsigned num_1(num_zero_middle_multiple);
+    BigUnsigned num_2 = num_1;
+    num_2.digits.back() -= 1; // same length, differs in the last digit
+#if defined(__cpp_lib_three_way_comparison)
+    result_ty passed = (num_1 <=> num_2) == std::strong_ordering::greater && (num_2 <=> num_1) == std::strong_ordering::less;
+#else
+    result_ty passed = compare(num_1, num_2) > 0 && compare(num_2, num_1) < 0;
+#endif
+
+    insert_result(Test_Info(29, 3), passed);
+
+}
+
+// hashing tests
+
+void test_30_1() {
+
+    BigUnsigned num_1(num_zero_middle_multiple);
+    BigUnsigned num_2 = BigUnsigned(num_zero_middle_multiple) * BigUnsigned(num_one);
+    std::hash<BigUnsigned> hasher;
+    result_ty passed = hasher(num_1) == hasher(num_2) && hasher(num_1) == std::hash<BigUnsignedView>()(BigUnsignedView(num_1)) &&
+                       hasher(num_1) != hasher(num_1 + BigUnsigned(num_one));
+
+    insert_result(Test_Info(30, 1), passed);
+
+}
+
+void test_30_2() {
+
+    std::unordered_set<BigUnsigned> nums;
+    for (int i = 0; i != 3; ++i) {
+        nums.insert(BigUnsigned(num_normal_1));
+        nums.insert(BigUnsigned(num_normal_2));
+        nums.insert(BigUnsigned());
+    }
+
+    insert_result(Test_Info(30, 2), nums.size() == 3 && nums.count(BigUnsigned(num_normal_2)) == 1);
+
+}
+
+// signed number tests
+
+void test_31_1() {
+
+    BigInt num_1 = BigInt(num_normal_3) - BigInt(num_normal_2);
+
+    insert_result(Test_Info(31, 1), to_string(num_1) == "-98274890100012835608621800195317563943387");
+
+}
+
+void test_31_2() {
+
+    auto qr = divmod(BigInt("-" + num_normal_2), BigInt(num_normal_3)); // truncates toward zero
+
+    insert_result(Test_Info(31, 2), to_string(qr.first) == "-20986655102886130694896516273" && to_string(qr.second) == "-496979415163");
+
+}
+
+void test_31_3() {
+
+    BigInt num_1(-9223372036854775807ll - 1);
+    BigInt num_2 = BigInt(num_zero_middle_multiple) * BigInt(-1);
+    num_2 += BigInt(num_zero_middle_multiple);
+    result_ty passed = to_string(num_1) == "-9223372036854775808" && num_2.is_zero() && !num_2.negative &&
+                       BigInt("-0") == BigInt() && BigInt(-5) < BigInt(3) && BigInt(-5) < BigInt(-3);
+
+    insert_result(Test_Info(31, 3), passed);
+
+}
+
+// modular exponentiation tests
+
+void test_32_1() {
+
+    BigUnsigned num_1 = powmod(BigUnsigned(num_normal_1), BigUnsigned(num_nine_digits), BigUnsigned(num_normal_2)); // odd modulus
+
+    insert_result(Test_Info(32, 1), to_string(num_1) == "22510674139193698709074741299665950919711");
+
+}
+
+void test_32_2() {
+
+    BigUnsigned num_1 = powmod(BigUnsigned(num_zero_middle_multiple), BigUnsigned(num_nine_digits), BigUnsigned(num_zero_end)); // even modulus
+
+    insert_result(Test_Info(32, 2), to_string(num_1) == "389118813364301016772690399992128611");
+
+}
+
+void test_32_3() {
+
+    BigUnsigned num_1(num_zero_middle_multiple);
+    result_ty passed = powmod(num_1, BigUnsigned(), num_1) == BigUnsigned(1u) && powmod(num_1, num_1, BigUnsigned(1u)).digits.empty() &&
+                       powmod(num_1, BigUnsigned(num_normal_3), num_1).digits.empty() &&
+                       to_string(powmod(BigUnsigned(num_normal_1), BigUnsigned(num_normal_3), num_1)) == "73579224679847659945730069060432169054990959221115117766231192135653551672771403";
+
+    insert_result(Test_Info(32, 3), passed);
+
+}
+
+// montgomery multiplication tests
+
+void test_33_1() {
+
+    MontgomeryContext mont{BigUnsigned(num_normal_2)};
+    std::vector<limb> num_1(mont.size());
+    std::vector<limb> num_2(mont.size());
+    mont.to_mont(num_1, BigUnsigned(num_normal_1)); // both are larger than the modulus
+    mont.to_mont(num_2, BigUnsigned(num_nine_nine));
+    mont.mul(num_1, num_1, num_2);
+    BigUnsigned product = mont.from_mont(num_1);
+    mont.sqr(num_2, num_2);
+    mont.mul(num_1, num_1, num_2);
+    result_ty passed = to_string(product) == "83682897985879146491621264346322115736309" &&
+                  to_string(mont.from_mont(num_1)) == "17779945971343277242204841302944436457145";
+
+    insert_result(Test_Info(33, 1), passed);
+
+}
+
+void test_33_2() {
+
+    MontgomeryContext mont{BigUnsigned(num_normal_2)};
+    std::vector<limb> num_1(mont.size());
+    std::vector<limb> num_2(mont.size());
+    std::vector<limb> res(mont.size());
+    mont.to_mont(num_1, BigUnsigned(num_normal_3));
+    mont.to_mont(num_2, BigUnsigned(num_normal_2) - BigUnsigned(1u));
+    mont.add(res, num_1, num_2); // wraps past the modulus
+    result_ty passed = to_string(mont.from_mont(res)) == "4682732413441";
+    mont.sub(res, num_1, num_2); // wraps below 0
+    passed = passed && to_string(mont.from_mont(res)) == "4682732413443";
+
+    insert_result(Test_Info(33, 2), passed);
+
+}
+
+void test_33_3() {
+
+    result_ty passed = false;
+    try {
+        MontgomeryContext mont{BigUnsigned(num_zero_end)};
+    } catch (const std::invalid_argument&) {
+        passed = true;
+    }
+
+    insert_result(Test_Info(33, 3), passed);
+
+}
+
+// power tests
+
+void test_34_1() {
+
+    BigUnsigned num_1 = pow(BigUnsigned(num_normal_3), 7);
+
+    insert_result(Test_Info(34, 1), to_string(num_1) == "49373667775365038948507987761564310981039859177421318855151713065680602997113889312440448");
+
+}
+
+void test_34_2() {
+
+    BigUnsigned num_1 = pow(BigUnsigned(num_zero_end), BigUnsigned(3u)); // even, the power of 2 is shifted in
+
+    insert_result(Test_Info(34, 2), to_string(num_1) == "93519768172608799511116648664409737362651373465700778444580684126815441647373173299922573100866883723198464");
+
+}
+
+void test_34_3() {
+
+    result_ty passed = to_string(pow(BigUnsigned(2u), 100)) == "1267650600228229401496703205376" &&
+                       pow(BigUnsigned(num_normal_1), 0) == BigUnsigned(1u) && pow(BigUnsigned(), 5).digits.empty();
+
+    insert_result(Test_Info(34, 3), passed);
+
+}
+
+// greatest common divisor tests
+
+void test_35_1() {
+
+    BigUnsigned num_1 = BigUnsigned(num_nine_digits) * BigUnsigned(num_normal_3);
+    BigUnsigned num_2 = BigUnsigned(num_zero_middle_multiple) * BigUnsigned(num_normal_3);
+
+    insert_result(Test_Info(35, 1), gcd(num_1, num_2) == BigUnsigned(num_normal_3));
+
+}
+
+void test_35_2() {
+
+    BigUnsigned num_1 = lcm(BigUnsigned(num_normal_3), BigUnsigned(num_zero_end));
+
+    insert_result(Test_Info(35, 2), to_string(num_1) == "1062764778905354969500364677073224812303099101184");
+
+}
+
+void test_35_3() {
+
+    BigUnsigned num_1(num_normal_1);
+    BigUnsigned num_2(num_normal_2);
+    auto res = gcdext(num_1, num_2);
+    result_ty passed = std::get<0>(res) == BigUnsigned(1u) &&
+                       std::get<1>(res) * BigInt(num_1) + std::get<2>(res) * BigInt(num_2) == BigInt(1);
+
+    insert_result(Test_Info(35, 3), passed);
+
+}
+
+// modular inverse and chinese remainder tests
+
+void test_36_1() {
+
+    BigUnsigned num_1 = invert(BigUnsigned(num_normal_1), BigUnsigned(num_normal_2)); // larger than the modulus
+
+    insert_result(Test_Info(36, 1), to_string(num_1) == "96590730244125144403529578351097702073974");
+
+}
+
+void test_36_2() {
+
+    std::vector<BigUnsigned> residues = {BigUnsigned(num_normal_1), BigUnsigned(num_normal_3), BigUnsigned(num_zero_middle)};
+    CrtTree tree({BigUnsigned(num_normal_2), BigUnsigned(num_zero_middle_multiple), BigUnsigned(1000000007u)});
+    BigUnsigned num_1 = tree.combine(residues);
+
+    insert_result(Test_Info(36, 2), to_string(num_1) == "403563269759725658730575136289280847349615465940489170145504042982173127414983823804248356205554741999519172008991860437498882179");
+
+}
+
+void test_36_3() {
+
+    result_ty passed = false;
+    try {
+        crt({BigUnsigned(1u), BigUnsigned(2u)}, {BigUnsigned(num_zero_end), BigUnsigned(num_normal_3)}); // both even
+    } catch (const std::domain_error&) {
+        passed = true;
+    }
+
+    insert_result(Test_Info(36, 3), passed);
+
+}
+
+// root tests
+
+void test_37_1() {
+
+    auto res = isqrt_rem(BigUnsigned(num_nine_digits));
+
+    insert_result(Test_Info(37, 1), to_string(res.first) == "1016164340676923811732251054235192967007150" &&
+                                    to_string(res.second) == "1588553777228106687650717560076143997920385");
+
+}
+
+void test_37_2() {
+
+    BigUnsigned num_1 = iroot(BigUnsigned(num_nine_digits), 3);
+
+    insert_result(Test_Info(37, 2), to_string(num_1) == "10107474019731534727996289349");
+
+}
+
+void test_37_3() {
+
+    BigUnsigned num_1(num_nine_digits);
+    BigUnsigned num_2 = num_1 * num_1;
+    result_ty passed = is_perfect_square(num_2) && !is_perfect_square(num_2 + 1) && !is_perfect_square(num_2 - 1) &&
+                       !is_perfect_square(num_1) && is_perfect_square(BigUnsigned());
+
+    insert_result(Test_Info(37, 3), passed);
+
+}
+
+// prime tests
+
+void test_38_1() {
+
+    BigUnsigned num_1("170141183460469231731687303715884105727"); // 2^127 - 1
+    result_ty passed = is_probable_prime(num_1) && is_probable_prime(num_1, 5) && !is_probable_prime(num_1 * num_1) &&
+                       is_probable_prime(BigUnsigned(2u)) && !is_probable_prime(BigUnsigned(1u)) && !is_probable_prime(BigUnsigned());
+
+    insert_result(Test_Info(38, 1), passed);
+
+}
+
+void test_38_2() {
+
+    // strong pseudoprimes to the bases 2 through 37 with no small factor
+    result_ty passed = !is_probable_prime(BigUnsigned("3825123056546413051")) &&
+                       !is_probable_prime(BigUnsigned("318665857834031151167461")) &&
+                       !is_probable_prime(BigUnsigned("3317044064679887385961981"));
+
+    insert_result(Test_Info(38, 2), passed);
+
+}
+
+void test_38_3() {
+
+    BigUnsigned num_1 = next_prime(BigUnsigned(num_normal_2));
+    BigUnsigned num_2 = next_prime(BigUnsigned(1013u));
+
+    insert_result(Test_Info(38, 3), to_string(num_1) == "98274890100012835608621800200000296356903" && num_2 == BigUnsigned(1019u) &&
+                                    next_prime(BigUnsigned()) == BigUnsigned(2u));
+
+}
+
+// factorial tests
+
+void test_39_1() {
+
+    BigUnsigned num_1 = factorial(60);
+
+    insert_result(Test_Info(39, 1), to_string(num_1) == "8320987112741390144276341183223364380754172606361245952449277696409600000000000000" &&
+                                    factorial(0) == BigUnsigned(1u));
+
+}
+
+void test_39_2() {
+
+    BigUnsigned num_1 = binomial(100, 37);
+    BigUnsigned num_2 = binomial(4000000000ull, 3);
+
+    insert_result(Test_Info(39, 2), to_string(num_1) == "3420029547493938143902737600" &&
+                                    to_string(num_2) == "10666666658666666668000000000" &&
+                                    binomial(5, 6) == BigUnsigned() && binomial(7, 7) == BigUnsigned(1u));
+
+}
+
+void test_39_3() {
+
+    BigUnsigned num_1 = primorial(100);
+
+    insert_result(Test_Info(39, 3), to_string(num_1) == "2305567963945518424753102147331756070" && primorial(1) == BigUnsigned(1u));
+
+}
+
+// product and sum tests
+
+void test_40_1() {
+
+    std::vector<BigUnsigned> nums {BigUnsigned(num_normal_1), BigUnsigned(num_normal_2), BigUnsigned(num_normal_3), BigUnsigned(num_nine_digits), BigUnsigned(num_zero_middle)};
+    BigUnsigned num_1(1u);
+    for (const auto& num : nums) {
+        num_1 = num_1 * num;
+    }
+
+    insert_result(Test_Info(40, 1), product(nums.cbegin(), nums.cend()) == num_1 && product(parallel, nums.cbegin(), nums.cend()) == num_1 &&
+                                    product(nums.cbegin(), nums.cbegin()) == BigUnsigned(1u));
+
+}
+
+void test_40_2() {
+
+    std::vector<BigUnsigned> nums {BigUnsigned(num_nine_nine), BigUnsigned(num_zero), BigUnsigned(num_nine_nine), BigUnsigned(num_normal_3)};
+    BigUnsigned num_1;
+    for (const auto& num : nums) {
+        num_1 = num_1 + num;
+    }
+
+    insert_result(Test_Info(40, 2), sum(nums.cbegin(), nums.cend()) == num_1 && sum(parallel, nums.cbegin(), nums.cend()) == num_1 &&
+                                    product(nums.cbegin(), nums.cend()) == BigUnsigned() && sum(nums.cbegin(), nums.cbegin()) == BigUnsigned());
+
+}
+
+// fibonacci tests
+
+void test_41_1() {
+
+    BigUnsigned num_1 = fibonacci(300);
+
+    insert_result(Test_Info(41, 1), to_string(num_1) == "222232244629420445529739893461909967206666939096499764990979600" &&
+                                    fibonacci(0) == BigUnsigned() && fibonacci(93) == BigUnsigned(12200160415121876738ull));
+
+}
+
+void test_41_2() {
+
+    BigUnsigned num_1 = lucas(300);
+
+    insert_result(Test_Info(41, 2), to_string(num_1) == "496926405783746676393791436882468230898067489522034699520200002" &&
+                                    lucas(0) == BigUnsigned(2u) && lucas(1) == BigUnsigned(1u));
+
+}
+
+// parallel multiplication tests
+
+void test_42_1() {
+
+    BigUnsigned num_1(num_nine_digits);
+    BigUnsigned num_2 = num_1 * BigUnsigned(num_zero_middle_multiple);
+    BigUnsigned num_3 = num_2 * num_2;
+    BigUnsigned num_4 = num_3 * num_1;
+
+    set_parallel_threads(4);
+    set_parallel_mul_digits(2);
+    BigUnsigned num_5 = num_1 * BigUnsigned(num_zero_middle_multiple);
+    BigUnsigned num_6 = num_5 * num_5;
+    BigUnsigned num_7 = num_6 * num_1;
+    set_parallel_mul_digits(0);
+    set_parallel_threads(0);
+
+    insert_result(Test_Info(42, 1), num_2 == num_5 && num_3 == num_6 && num_4 == num_7);
+
+}
+
+// parallel conversion tests
+
+void test_43_1() {
+
+    BigUnsigned num_1(num_nine_digits);
+    num_1 = num_1 * num_1 * num_1 * BigUnsigned(num_zero_middle_multiple);
+    std::string str_1 = to_string(num_1);
+
+    set_parallel_threads(4);
+    set_parallel_convert_digits(2);
+    std::string str_2 = to_string(num_1);
+    BigUnsigned num_2(str_1);
+    set_parallel_convert_digits(0);
+    set_parallel_threads(0);
+
+    insert_result(Test_Info(43, 1), str_1 == str_2 && num_1 == num_2);
+
+}
+
+void test_43_2() {
+
+    BigUnsigned num_1(num_nine_digits);
+    num_1 = num_1 * num_1 * num_1 * num_1 * BigUnsigned(num_zero_middle_multiple);
+    std::string str_1 = to_string(num_1);
+
+    // powers past the limit are squared on every use, on the pool while conversions also run there
+    set_parallel_threads(4);
+    set_parallel_mul_digits(2);
+    set_parallel_convert_digits(2);
+    pow10_cache_clear();
+    pow10_cache_limit(64);
+    std::string str_2[2];
+    BigUnsigned num_2[2];
+    _parallel_pool().run(2, [&](std::size_t i) {
+        str_2[i] = to_string(num_1);
+        num_2[i] = BigUnsigned(str_1);
+    });
+    pow10_cache_limit(std::numeric_limits<std::size_t>::max());
+    set_parallel_convert_digits(0);
+    set_parallel_mul_digits(0);
+    set_parallel_threads(0);
+
+    insert_result(Test_Info(43, 2), str_2[0] == str_1 && str_2[1] == str_1 && num_2[0] == num_1 && num_2[1] == num_1);
+
+}
+
 // ------------------------------------------------------------------------------------------------
 
 // run all tests and output to file_name
@@ -480,11 +1404,83 @@ void run_tests(std::string file_name = "error.log") {
     test_17_2();
     test_17_3();
     test_17_4();
+    test_18_1();
+    test_18_2();
+    test_18_3();
+    test_18_4();
+    test_19_1();
+    test_20_1();
+    test_20_2();
+    test_21_1();
+    test_21_2();
+    test_22_1();
+    test_22_2();
+    test_22_3();
+    test_23_1();
+    test_23_2();
+    test_23_3();
+    test_24_1();
+    test_24_2();
+    test_24_3();
+    test_25_1();
+    test_25_2();
+    test_25_3();
+    test_26_1();
+    test_26_2();
+    test_26_3();
+    test_27_1();
+    test_27_2();
+    test_27_3();
+    test_28_1();
+    test_28_2();
+    test_28_3();
+    test_28_4();
+    test_28_5();
+    test_28_6();
+    test_29_1();
+    test_29_2();
+    test_29_3();
+    test_30_1();
+    test_30_2();
+    test_31_1();
+    test_31_2();
+    test_31_3();
+    test_32_1();
+    test_32_2();
+    test_32_3();
+    test_33_1();
+    test_33_2();
+    test_33_3();
+    test_34_1();
+    test_34_2();
+    test_34_3();
+    test_35_1();
+    test_35_2();
+    test_35_3();
+    test_36_1();
+    test_36_2();
+    test_36_3();
+    test_37_1();
+    test_37_2();
+    test_37_3();
+    test_38_1();
+    test_38_2();
+    test_38_3();
+    test_39_1();
+    test_39_2();
+    test_39_3();
+    test_40_1();
+    test_40_2();
+    test_41_1();
+    test_41_2();
+    test_42_1();
+    test_43_1();
+    test_43_2();
 
     std::fstream outf;
     outf.open(file_name, std::ios::out);
 
-    const id_ty num_test = 29;
+    const id_ty num_test = 102;
 
     outf << "Passed " << (num_test - failures.size()) << " out of " << num_test << " tests" << std::endl;
 